@@ -1,5 +1,53 @@
-// Fill out your copyright notice in the Description page of Project Settings.
+﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 
 #include "BattleGameMode.h"
 
+#include "NetGameState.h"
+#include "NetTPSCD.h"
+#include "GameFramework/Pawn.h"
+
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Replication Bots" ) , STAT_RepBots , STATGROUP_NetTPSCD );
+
+ABattleGameMode::ABattleGameMode()
+{
+	// 채팅은 게임스테이트에서 모아서 처리한다.
+	GameStateClass = ANetGameState::StaticClass();
+}
+
+void ABattleGameMode::SpawnRepBots( int32 count )
+{
+	if (false == HasAuthority() || nullptr == DefaultPawnClass)
+		return;
+
+	// 첫번째 플레이어 주변에 격자로 늘어놓아서 모두 relevant 하게 하고싶다.
+	auto pc = GetWorld()->GetFirstPlayerController();
+	const FVector origin = pc && pc->GetPawn() ? pc->GetPawn()->GetActorLocation() : FVector::ZeroVector;
+	const int32 side = FMath::CeilToInt32( FMath::Sqrt( static_cast<float>(count) ) );
+
+	FActorSpawnParameters params;
+	params.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+	for (int32 i = 0; i < count; i++)
+	{
+		const FVector loc = origin + FVector( (i / side + 1) * 150.0f , (i % side - side / 2) * 150.0f , 0 );
+		auto bot = GetWorld()->SpawnActor<APawn>( DefaultPawnClass , loc , FRotator::ZeroRotator , params );
+		if (bot)
+		{
+			repBots.Add( bot );
+		}
+	}
+	SET_DWORD_STAT( STAT_RepBots , repBots.Num() );
+}
+
+void ABattleGameMode::DestroyRepBots()
+{
+	for (APawn* bot : repBots)
+	{
+		if (IsValid( bot ))
+		{
+			bot->Destroy();
+		}
+	}
+	repBots.Reset();
+	SET_DWORD_STAT( STAT_RepBots , 0 );
+}
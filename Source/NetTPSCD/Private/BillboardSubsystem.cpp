@@ -0,0 +1,84 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "BillboardSubsystem.h"
+
+#include "NetTPSCD.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT( TEXT( "Billboard Update" ) , STAT_BillboardUpdate , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Billboards Rotated" ) , STAT_BillboardsRotated , STATGROUP_NetTPSCD );
+
+void UBillboardSubsystem::Deinitialize()
+{
+	billboards.Reset();
+
+	Super::Deinitialize();
+}
+
+void UBillboardSubsystem::Tick( float DeltaTime )
+{
+	Super::Tick( DeltaTime );
+
+	SCOPE_CYCLE_COUNTER( STAT_BillboardUpdate );
+
+	// 카메라는 한번만 가져오고싶다.
+	auto pc = GetWorld()->GetFirstPlayerController();
+	if (nullptr == pc || nullptr == pc->PlayerCameraManager || billboards.Num() == 0)
+		return;
+
+	const FVector camLoc = pc->PlayerCameraManager->GetCameraLocation();
+	const FVector camForward = pc->PlayerCameraManager->GetCameraRotation().Vector();
+	// 화면 가장자리에 걸친 위젯도 돌리도록 시야각보다 조금 넓게 검사한다.
+	const float halfFov = FMath::DegreesToRadians( FMath::Min( pc->PlayerCameraManager->GetFOVAngle() * 0.5f + 10.0f , 89.0f ) );
+	const float minDot = FMath::Cos( halfFov );
+	const double maxDistSq = FMath::Square( MaxDistance );
+
+	for (int32 i = billboards.Num() - 1; i >= 0; i--)
+	{
+		USceneComponent* comp = billboards[i].Get();
+		if (nullptr == comp)
+		{
+			billboards.RemoveAtSwap( i );
+			continue;
+		}
+		if (false == comp->IsVisible())
+			continue;
+
+		const FVector compLoc = comp->GetComponentLocation();
+		const FVector dir = camLoc - compLoc;
+		const double distSq = dir.SizeSquared();
+		if (distSq > maxDistSq)
+			continue;
+
+		// 카메라가 보고 있지 않은 위젯은 건너뛴다.
+		if (distSq > KINDA_SMALL_NUMBER && FVector::DotProduct( -dir / FMath::Sqrt( distSq ) , camForward ) < minDot)
+			continue;
+
+		const FRotator rot = dir.GetSafeNormal2D().ToOrientationRotator();
+		if (FMath::Abs( FRotator::NormalizeAxis( rot.Yaw - comp->GetComponentRotation().Yaw ) ) < MinYawDelta)
+			continue;
+
+		comp->SetWorldRotation( rot );
+		INC_DWORD_STAT( STAT_BillboardsRotated );
+	}
+}
+
+TStatId UBillboardSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( UBillboardSubsystem , STATGROUP_Tickables );
+}
+
+void UBillboardSubsystem::Register( USceneComponent* comp )
+{
+	if (comp)
+	{
+		billboards.AddUnique( comp );
+	}
+}
+
+void UBillboardSubsystem::Unregister( USceneComponent* comp )
+{
+	billboards.RemoveSwap( comp );
+}
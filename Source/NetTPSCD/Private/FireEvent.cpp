@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "FireEvent.h"
+
+#include "Kismet/GameplayStatics.h"
+#include "UObject/CoreNet.h"
+
+void FFireEvent::SetHit( const FHitResult& hitInfo , bool bWithNormal )
+{
+	bHit = true;
+	bHasNormal = bWithNormal;
+	impactPoint = hitInfo.ImpactPoint;
+	impactNormal = hitInfo.ImpactNormal;
+	surface = static_cast<uint8>(UGameplayStatics::GetSurfaceType( hitInfo ));
+}
+
+bool FFireEvent::NetSerialize( FArchive& Ar , UPackageMap* Map , bool& bOutSuccess )
+{
+	bOutSuccess = true;
+
+	// 플래그 2비트
+	uint8 flags = (bHit ? 1 : 0) | (bHasNormal ? 2 : 0);
+	Ar.SerializeBits( &flags , 2 );
+	bHit = (flags & 1) != 0;
+	bHasNormal = (flags & 2) != 0;
+
+	// 안 맞았다면 위치도 재질도 보낼 필요가 없다.
+	if (bHit)
+	{
+		bool bPointSuccess = true;
+		impactPoint.NetSerialize( Ar , Map , bPointSuccess );
+		bOutSuccess &= bPointSuccess;
+
+		if (bHasNormal)
+		{
+			bool bNormalSuccess = true;
+			impactNormal.NetSerialize( Ar , Map , bNormalSuccess );
+			bOutSuccess &= bNormalSuccess;
+		}
+
+		Ar.SerializeBits( &surface , SurfaceBits );
+	}
+
+	return true;
+}
+
+int32 FFireEvent::CalcNetBytes() const
+{
+	FFireEvent copy = *this;
+	FNetBitWriter writer( nullptr , 256 );
+	bool bSuccess = true;
+	copy.NetSerialize( writer , nullptr , bSuccess );
+	return static_cast<int32>(writer.GetNumBytes());
+}
@@ -0,0 +1,80 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "HPBarLayerWidget.h"
+
+#include "EngineUtils.h"
+#include "NetTPSCD.h"
+#include "NetTPSCDCharacter.h"
+#include "Blueprint/WidgetLayoutLibrary.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Rendering/DrawElements.h"
+
+DECLARE_CYCLE_STAT( TEXT( "HPBar Layer Update" ) , STAT_HPBarLayerUpdate , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "HPBars Drawn" ) , STAT_HPBarsDrawn , STATGROUP_NetTPSCD );
+
+void UHPBarLayerWidget::NativeTick( const FGeometry& MyGeometry , float InDeltaTime )
+{
+	Super::NativeTick( MyGeometry , InDeltaTime );
+
+	SCOPE_CYCLE_COUNTER( STAT_HPBarLayerUpdate );
+
+	bars.Reset();
+
+	auto pc = GetOwningPlayer();
+	if (nullptr == pc || nullptr == pc->PlayerCameraManager)
+		return;
+
+	const FVector camLoc = pc->PlayerCameraManager->GetCameraLocation();
+	const double maxDistSq = FMath::Square( maxDistance );
+	const FVector2D layerSize = MyGeometry.GetLocalSize();
+
+	// 내가 아닌 캐릭터들을 화면에 투영해서 보이는 것만 모으고싶다.
+	for (TActorIterator<ANetTPSCDCharacter> It( GetWorld() ); It; ++It)
+	{
+		ANetTPSCDCharacter* character = *It;
+		if (character->IsLocallyControlled() || character->IsHidden())
+			continue;
+
+		const FVector headLoc = character->GetActorLocation() + FVector( 0 , 0 , heightOffset );
+		if (FVector::DistSquared( camLoc , headLoc ) > maxDistSq)
+			continue;
+
+		// 카메라 뒤에 있으면 false
+		FVector2D position;
+		if (false == UWidgetLayoutLibrary::ProjectWorldLocationToWidgetPosition( pc , headLoc , position , true ))
+			continue;
+
+		// 화면 밖이면 그리지 않는다.
+		if (position.X < -barSize.X || position.Y < -barSize.Y || position.X > layerSize.X + barSize.X || position.Y > layerSize.Y + barSize.Y)
+			continue;
+
+		FHPBarDraw& bar = bars.AddDefaulted_GetRef();
+		bar.position = position - barSize * 0.5f;
+		bar.hp = FMath::Clamp( static_cast<float>(character->GetHP()) / character->maxHP , 0.0f , 1.0f );
+	}
+	SET_DWORD_STAT( STAT_HPBarsDrawn , bars.Num() );
+}
+
+int32 UHPBarLayerWidget::NativePaint( const FPaintArgs& Args , const FGeometry& AllottedGeometry , const FSlateRect& MyCullingRect , FSlateWindowElementList& OutDrawElements , int32 LayerId , const FWidgetStyle& InWidgetStyle , bool bParentEnabled ) const
+{
+	LayerId = Super::NativePaint( Args , AllottedGeometry , MyCullingRect , OutDrawElements , LayerId , InWidgetStyle , bParentEnabled );
+
+	// 배경을 모두 그린 다음 채움을 모두 그려서 두 레이어로 한번에 배칭되게 하고싶다.
+	for (const FHPBarDraw& bar : bars)
+	{
+		FSlateDrawElement::MakeBox( OutDrawElements , LayerId + 1 ,
+			AllottedGeometry.ToPaintGeometry( barSize , FSlateLayoutTransform( bar.position ) ) ,
+			&barBrush , ESlateDrawEffect::None , backColor );
+	}
+	for (const FHPBarDraw& bar : bars)
+	{
+		if (bar.hp <= 0)
+			continue;
+
+		FSlateDrawElement::MakeBox( OutDrawElements , LayerId + 2 ,
+			AllottedGeometry.ToPaintGeometry( FVector2D( barSize.X * bar.hp , barSize.Y ) , FSlateLayoutTransform( bar.position ) ) ,
+			&barBrush , ESlateDrawEffect::None , fillColor );
+	}
+	return LayerId + 2;
+}
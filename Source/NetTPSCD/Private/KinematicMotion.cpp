@@ -0,0 +1,12 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "KinematicMotion.h"
+
+FQuat FKinematicMotion::Evaluate( double serverTime ) const
+{
+	// 오래 돌아도 float 정밀도가 떨어지지 않게 한바퀴 안쪽 각도로 바꾼다.
+	const double angle = FMath::Fmod( angularSpeed * FMath::Max( serverTime - startTime , 0.0 ) , 360.0 );
+	const FQuat delta( axis.GetSafeNormal( SMALL_NUMBER , FVector::UpVector ) , FMath::DegreesToRadians( angle ) );
+	return delta * startRotation.Quaternion();
+}
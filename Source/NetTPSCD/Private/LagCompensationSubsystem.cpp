@@ -0,0 +1,252 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "LagCompensationSubsystem.h"
+
+#include "NetTPSCD.h"
+#include "NetTPSCDCharacter.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/GameStateBase.h"
+
+DECLARE_CYCLE_STAT( TEXT( "LagCompensation Record" ) , STAT_LagCompensationRecord , STATGROUP_NetTPSCD );
+DECLARE_CYCLE_STAT( TEXT( "LagCompensation Rewind" ) , STAT_LagCompensationRewind , STATGROUP_NetTPSCD );
+
+static_assert(FMath::IsPowerOfTwo( FHitboxHistory::Capacity ) , "FHitboxHistory::Capacity must be a power of two");
+
+void FHitboxHistory::Reset()
+{
+	head = 0;
+	num = 0;
+}
+
+void FHitboxHistory::Record( double time , const FHitboxPose& pose )
+{
+	times[head] = time;
+	poses[head] = pose;
+	head = (head + 1) & (Capacity - 1);
+	num = FMath::Min( num + 1 , Capacity );
+}
+
+bool FHitboxHistory::Sample( double time , FHitboxPose& outPose ) const
+{
+	if (num <= 0)
+		return false;
+
+	// 가장 오래된 기록부터 i번째 기록의 실제 인덱스
+	const int32 oldest = (head - num + Capacity) & (Capacity - 1);
+	auto at = [oldest]( int32 i ) { return (oldest + i) & (Capacity - 1); };
+
+	// 범위 밖이라면 가장 가까운 기록을 쓰고싶다.
+	if (time <= times[at( 0 )])
+	{
+		outPose = poses[at( 0 )];
+		return true;
+	}
+	if (time >= times[at( num - 1 )])
+	{
+		outPose = poses[at( num - 1 )];
+		return true;
+	}
+
+	// 시간은 항상 증가하므로 이진탐색으로 time 바로 뒤의 기록을 찾고싶다.
+	int32 lo = 1;
+	int32 hi = num - 1;
+	while (lo < hi)
+	{
+		const int32 mid = (lo + hi) / 2;
+		if (times[at( mid )] < time)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	const int32 prev = at( lo - 1 );
+	const int32 next = at( lo );
+	const double span = times[next] - times[prev];
+	const float alpha = span > UE_SMALL_NUMBER ? static_cast<float>((time - times[prev]) / span) : 1.0f;
+
+	outPose.location = FMath::Lerp( poses[prev].location , poses[next].location , alpha );
+	outPose.radius = FMath::Lerp( poses[prev].radius , poses[next].radius , alpha );
+	outPose.halfHeight = FMath::Lerp( poses[prev].halfHeight , poses[next].halfHeight , alpha );
+	return true;
+}
+
+// 수직으로 서있는 캡슐과 선분(start ~ start+delta)이 처음 만나는 비율 t(0~1)를 구하고싶다.
+// 캡슐 = 원기둥 + 위아래 구 이므로 각각의 진입 시점 중 가장 빠른 것이 답이다.
+static bool IntersectCapsule( const FVector& start , const FVector& delta , const FHitboxPose& pose , double& outT )
+{
+	const double r = pose.radius;
+	const double halfCylinder = FMath::Max<double>( pose.halfHeight - pose.radius , 0 );
+	const FVector p = start - pose.location;
+	double best = TNumericLimits<double>::Max();
+
+	// 원기둥 옆면 (XY 평면에서의 원과 교차)
+	const double a = delta.X * delta.X + delta.Y * delta.Y;
+	if (a > UE_SMALL_NUMBER)
+	{
+		const double b = 2 * (p.X * delta.X + p.Y * delta.Y);
+		const double c = p.X * p.X + p.Y * p.Y - r * r;
+		const double disc = b * b - 4 * a * c;
+		if (disc >= 0)
+		{
+			const double t = (-b - FMath::Sqrt( disc )) / (2 * a);
+			const double z = p.Z + delta.Z * t;
+			if (t >= 0 && t <= 1 && FMath::Abs( z ) <= halfCylinder)
+			{
+				best = t;
+			}
+		}
+	}
+
+	// 위아래 반구
+	const double qa = delta.SizeSquared();
+	if (qa > UE_SMALL_NUMBER)
+	{
+		for (const double capZ : { halfCylinder , -halfCylinder })
+		{
+			const FVector q = p - FVector( 0 , 0 , capZ );
+			const double qb = 2 * FVector::DotProduct( q , delta );
+			const double qc = q.SizeSquared() - r * r;
+			const double disc = qb * qb - 4 * qa * qc;
+			if (disc < 0)
+				continue;
+
+			const double t = (-qb - FMath::Sqrt( disc )) / (2 * qa);
+			if (t >= 0 && t <= 1 && t < best)
+			{
+				best = t;
+			}
+		}
+	}
+
+	if (best > 1)
+		return false;
+
+	outT = best;
+	return true;
+}
+
+void ULagCompensationSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	// 방 최대 인원(10명)만큼은 미리 잡아두고싶다.
+	characters.Reserve( 10 );
+	histories.Reserve( 10 );
+}
+
+void ULagCompensationSubsystem::Tick( float DeltaTime )
+{
+	Super::Tick( DeltaTime );
+
+	if (characters.Num() == 0)
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_LagCompensationRecord );
+
+	// 이번 프레임의 캡슐 자세를 모두 기록하고싶다.
+	const double now = GetServerTime();
+	for (int32 i = 0; i < characters.Num(); i++)
+	{
+		const ANetTPSCDCharacter* character = characters[i].Get();
+		if (nullptr == character)
+			continue;
+
+		const UCapsuleComponent* capsule = character->GetCapsuleComponent();
+		FHitboxPose pose;
+		pose.location = capsule->GetComponentLocation();
+		pose.radius = capsule->GetScaledCapsuleRadius();
+		pose.halfHeight = capsule->GetScaledCapsuleHalfHeight();
+		histories[i].Record( now , pose );
+	}
+}
+
+TStatId ULagCompensationSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( ULagCompensationSubsystem , STATGROUP_Tickables );
+}
+
+void ULagCompensationSubsystem::Register( ANetTPSCDCharacter* character )
+{
+	if (nullptr == character || characters.Contains( character ))
+		return;
+
+	characters.Add( character );
+	histories.AddDefaulted_GetRef().Reset();
+}
+
+void ULagCompensationSubsystem::Unregister( ANetTPSCDCharacter* character )
+{
+	const int32 index = characters.IndexOfByKey( character );
+	if (INDEX_NONE == index)
+		return;
+
+	characters.RemoveAtSwap( index );
+	histories.RemoveAtSwap( index );
+}
+
+bool ULagCompensationSubsystem::RewindLineTrace( FHitResult& outHit , const FVector& start , const FVector& end , double time , const AActor* ignoreActor ) const
+{
+	SCOPE_CYCLE_COUNTER( STAT_LagCompensationRewind );
+
+	// 너무 오래된 시점이나 미래 시점으로는 되감지 않는다.
+	const double now = GetServerTime();
+	time = FMath::Clamp( time , now - MaxRewindTime , now );
+
+	// 캐릭터를 제외한 월드에 먼저 쏴서 벽에 막히는 거리를 구하고싶다.
+	FCollisionQueryParams params;
+	params.AddIgnoredActor( ignoreActor );
+	params.bReturnPhysicalMaterial = true;
+	for (const auto& character : characters)
+	{
+		params.AddIgnoredActor( character.Get() );
+	}
+	const bool bWorldHit = GetWorld()->LineTraceSingleByChannel( outHit , start , end , ECollisionChannel::ECC_Visibility , params );
+
+	// 벽보다 앞에 있던 캐릭터 중 가장 가까운 캐릭터를 찾고싶다.
+	const FVector delta = end - start;
+	double bestT = bWorldHit ? outHit.Time : 1.0;
+	int32 bestIndex = INDEX_NONE;
+	FHitboxPose bestPose;
+	for (int32 i = 0; i < characters.Num(); i++)
+	{
+		const ANetTPSCDCharacter* character = characters[i].Get();
+		if (nullptr == character || character == ignoreActor)
+			continue;
+
+		FHitboxPose pose;
+		double t;
+		if (histories[i].Sample( time , pose ) && IntersectCapsule( start , delta , pose , t ) && t < bestT)
+		{
+			bestT = t;
+			bestIndex = i;
+			bestPose = pose;
+		}
+	}
+
+	if (INDEX_NONE == bestIndex)
+		return bWorldHit;
+
+	// 되감긴 캡슐에 맞은 결과로 outHit를 채우고싶다.
+	ANetTPSCDCharacter* hitCharacter = characters[bestIndex].Get();
+	const FVector point = start + delta * bestT;
+	const float halfCylinder = FMath::Max( bestPose.halfHeight - bestPose.radius , 0.0f );
+	const FVector axisPoint = bestPose.location + FVector( 0 , 0 , FMath::Clamp<double>( point.Z - bestPose.location.Z , -halfCylinder , halfCylinder ) );
+	const FVector normal = (point - axisPoint).GetSafeNormal();
+
+	outHit = FHitResult( hitCharacter , hitCharacter->GetCapsuleComponent() , point , normal );
+	outHit.Time = bestT;
+	outHit.Distance = delta.Size() * bestT;
+	outHit.TraceStart = start;
+	outHit.TraceEnd = end;
+	return true;
+}
+
+double ULagCompensationSubsystem::GetServerTime() const
+{
+	if (auto gs = GetWorld()->GetGameState())
+	{
+		return gs->GetServerWorldTimeSeconds();
+	}
+	return GetWorld()->GetTimeSeconds();
+}
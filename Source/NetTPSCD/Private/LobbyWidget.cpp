@@ -5,6 +5,7 @@
 
 #include "NetGameInstance.h"
 #include "RoomInfoWidget.h"
+#include "TextFilterSubsystem.h"
 #include "Components/Button.h"
 #include "Components/EditableText.h"
 #include "Components/ScrollBox.h"
@@ -65,16 +66,12 @@ void ULobbyWidget::OnMyClicked_doCreateRoom()
 		return;
 	}
 
-	TArray<FString> badWords;
-	badWords.Add( TEXT( "바보" ) );
-	badWords.Add( TEXT( "똥개" ) );
-	for (int i = 0; i < badWords.Num(); i++)
+	// 금지어가 들어있으면 방을 만들지 않는다.
+	auto textFilter = UTextFilterSubsystem::Get( this );
+	if (textFilter && textFilter->Contains( roomName ))
 	{
-		if (roomName.Contains( badWords[i] ))
-		{
-			UE_LOG( LogTemp , Warning , TEXT( "방 이름이 적절하지 않습니다." ) );
-			return;
-		}
+		UE_LOG( LogTemp , Warning , TEXT( "방 이름이 적절하지 않습니다." ) );
+		return;
 	}
 
 
@@ -6,11 +6,14 @@
 #include "MessageUI.h"
 #include "NetGameInstance.h"
 #include "NetPlayerController.h"
+#include "NetPlayerState.h"
 #include "NetTPSCDCharacter.h"
+#include "TextFilterSubsystem.h"
 #include "Components/Button.h"
 #include "Components/CanvasPanel.h"
 #include "Components/EditableText.h"
 #include "Components/Image.h"
+#include "Components/ListView.h"
 #include "Components/ScrollBox.h"
 #include "Components/TextBlock.h"
 #include "Components/UniformGridPanel.h"
@@ -26,6 +29,21 @@ void UMainUI::NativeConstruct()
 	btn_quit->OnClicked.AddDynamic( this , &UMainUI::OnMyClickQuit );
 	btn_exit->OnClicked.AddDynamic( this , &UMainUI::OnMyClickQuit );
 	btn_sendMsg->OnClicked.AddDynamic( this , &UMainUI::OnMySendMsg );
+
+	// 점수판은 이름/점수가 바뀔 때만 갱신하고싶다.
+	playerStateChangedHandle = ANetPlayerState::OnPlayerStateChanged.AddUObject( this , &UMainUI::OnPlayerStateChanged );
+	playerStateRemovedHandle = ANetPlayerState::OnPlayerStateRemoved.AddUObject( this , &UMainUI::OnPlayerStateRemoved );
+
+	// 이미 들어와 있는 유저들로 채운다.
+	scoreRows.Reset();
+	if (auto gs = GetWorld()->GetGameState())
+	{
+		for (APlayerState* ps : gs->PlayerArray)
+		{
+			UpdateScoreRow( ps );
+		}
+	}
+	RefreshScoreboard();
 }
 
 void UMainUI::SetActiveCrosshair( bool bActive )
@@ -48,13 +66,16 @@ void UMainUI::SetActiveCrosshair( bool bActive )
 
 void UMainUI::ReloadBulletUI( int32 maxBulletCount )
 {
-	// 기존에 grid_bullet의 자식들을 모두 삭제하고
-	grid_bullet->ClearChildren();
-	// 다시 maxBulletCount만큼 생성하고싶다.
-	for (int32 i = 0; i < maxBulletCount; i++)
+	// 모자란 만큼만 처음 한번 생성하고
+	while (bulletIcons.Num() < maxBulletCount)
 	{
 		AddBulletUI();
 	}
+	// maxBulletCount만큼 보이고 나머지는 숨기고싶다.
+	for (int32 i = 0; i < bulletIcons.Num(); i++)
+	{
+		SetBulletVisible( i , i < maxBulletCount );
+	}
 }
 
 void UMainUI::AddBulletUI()
@@ -62,14 +83,27 @@ void UMainUI::AddBulletUI()
 	// 총알 위젯을 만들고
 	auto bulletUI = CreateWidget( this , bulletUIFactory );
 	// grid에 자식으로 붙인다.
-	grid_bullet->AddChildToUniformGrid( bulletUI , 0 , grid_bullet->GetChildrenCount() );
+	grid_bullet->AddChildToUniformGrid( bulletUI , 0 , bulletIcons.Num() );
+	bulletIcons.Add( bulletUI );
 }
 
 // index는 0부터 시작한다.
 void UMainUI::RemoveBulletUI( int32 index )
 {
-	// grid의 index위치의 자식을 제거한다.
-	grid_bullet->RemoveChildAt( index );
+	// grid에서 빼지 않고 index위치의 총알만 숨긴다.
+	SetBulletVisible( index , false );
+}
+
+void UMainUI::SetBulletVisible( int32 index , bool bVisible )
+{
+	if (false == bulletIcons.IsValidIndex( index ))
+		return;
+
+	const ESlateVisibility visibility = bVisible ? ESlateVisibility::HitTestInvisible : ESlateVisibility::Hidden;
+	if (bulletIcons[index]->GetVisibility() != visibility)
+	{
+		bulletIcons[index]->SetVisibility( visibility );
+	}
 }
 
 void UMainUI::PlayHitAnim()
@@ -106,22 +140,63 @@ void UMainUI::OnMyClickQuit()
 	btn_quit->SetIsEnabled( false );
 }
 
-void UMainUI::NativeTick(const FGeometry& MyGeometry, float InDeltaTime)
+void UMainUI::NativeDestruct()
 {
-	Super::NativeTick(MyGeometry , InDeltaTime);
+	ANetPlayerState::OnPlayerStateChanged.Remove( playerStateChangedHandle );
+	ANetPlayerState::OnPlayerStateRemoved.Remove( playerStateRemovedHandle );
 
-	// 전체 유저들의 이름을 알고싶다.
-	auto playerList = GetWorld()->GetGameState()->PlayerArray;
-	FString txt;
+	Super::NativeDestruct();
+}
+
+void UMainUI::OnPlayerStateChanged( ANetPlayerState* ps )
+{
+	if (ps && ps->GetWorld() == GetWorld())
+	{
+		UpdateScoreRow( ps );
+	}
+}
+
+void UMainUI::OnPlayerStateRemoved( ANetPlayerState* ps )
+{
+	const int32 removed = scoreRows.RemoveAll( [ps]( const FScoreRow& row ) { return row.ps == ps || false == row.ps.IsValid(); } );
+	if (removed > 0)
+	{
+		RefreshScoreboard();
+	}
+}
+
+void UMainUI::UpdateScoreRow( APlayerState* ps )
+{
+	const int32 _score = static_cast<int32>(ps->GetScore());
+	FString text = FString::Printf( TEXT( "%s : %d점" ) , *ps->GetPlayerName() , _score );
+
+	FScoreRow* row = scoreRows.FindByPredicate( [ps]( const FScoreRow& item ) { return item.ps == ps; } );
+	if (nullptr == row)
+	{
+		row = &scoreRows.AddDefaulted_GetRef();
+		row->ps = ps;
+	}
+	else if (row->text == text)
+	{
+		// 바뀐 것이 없다면 다시 그리지 않는다.
+		return;
+	}
+
+	row->text = MoveTemp( text );
+	RefreshScoreboard();
+}
+
+void UMainUI::RefreshScoreboard()
+{
 	// 그 이름들을 모두 모아
-	for (const APlayerState* ps : playerList)
+	FString txt;
+	for (const FScoreRow& row : scoreRows)
 	{
-		const int32 _score = static_cast<int32>(ps->GetScore());
-		txt.Append( FString::Printf( TEXT("%s : %d점\n") , *ps->GetPlayerName(), _score ) );
+		txt.Append( row.text );
+		txt.AppendChar( TEXT( '\n' ) );
 	}
 	// 화면에 출력하고싶다.
 	txt_players->SetText( FText::FromString( txt ) );
-
 }
 
 void UMainUI::OnMySendMsg()
@@ -131,30 +206,60 @@ void UMainUI::OnMySendMsg()
 	if (msg.IsEmpty())
 		return;
 
-	TArray<FString> badwordList;
-	badwordList.Add( TEXT( "바보" ) );
-
-
-	for (int i=0 ; i< badwordList.Num(); i++)
+	// 금지어는 글자 수만큼 가린다. (서버에서도 한번 더 검사한다)
+	if (auto textFilter = UTextFilterSubsystem::Get( this ))
 	{
-		msg = msg.Replace( *badwordList[i], TEXT("**") );
+		textFilter->Mask( msg );
 	}
 
-	// 현재 로컬 플레이어에게 서버로 메시지를 전달하라고 요청
-	auto player = Cast<ANetTPSCDCharacter>(GetWorld()->GetFirstPlayerController()->GetPawn());
-	if (player)
+	// 폰이 아니라 내 플레이어 컨트롤러를 통해 서버로 메시지를 전달하라고 요청
+	auto pc = Cast<ANetPlayerController>( GetWorld()->GetFirstPlayerController() );
+	if (pc)
 	{
-		player->ServerSendMsg( msg );
+		pc->ServerSendChat( msg );
 	}
 }
 
 void UMainUI::RecvMsg(const FString& msg)
 {
-	// wbp_msg를 생성해서
-	auto msgUI = CreateWidget<UMessageUI>( GetWorld() , msgUIFactory );
+	if (list_msg)
+	{
+		// 가득 차기 전까지만 아이템을 만들고 그 뒤로는 가장 오래된 아이템을 다시 쓰고싶다.
+		UChatMessageItem* item = nullptr;
+		if (chatItems.Num() < MaxChatMessages)
+		{
+			item = NewObject<UChatMessageItem>( this );
+			chatItems.Add( item );
+		}
+		else
+		{
+			item = chatItems[chatHead];
+			chatHead = (chatHead + 1) % MaxChatMessages;
+			list_msg->RemoveItem( item );
+		}
+		item->msg = msg;
+		list_msg->AddItem( item );
+		list_msg->ScrollToBottom();
+		return;
+	}
+
+	UMessageUI* msgUI = nullptr;
+	if (scroll_msg->GetChildrenCount() >= MaxChatMessages)
+	{
+		// 가득 찼다면 가장 오래된 위젯을 떼어서 다시 쓰고싶다.
+		msgUI = Cast<UMessageUI>( scroll_msg->GetChildAt( 0 ) );
+		scroll_msg->RemoveChildAt( 0 );
+	}
+	if (nullptr == msgUI)
+	{
+		// 다시 쓸 위젯이 없다면 wbp_msg를 생성해서
+		msgUI = CreateWidget<UMessageUI>( GetWorld() , msgUIFactory );
+	}
+	if (nullptr == msgUI || nullptr == msgUI->txt_msg)
+		return;
+
 	// 메시지를 UI에 적용하고
 	msgUI->txt_msg->SetText( FText::FromString( msg ) );
 	// scroll_msg 에 자식으로 붙이고싶다.
 	scroll_msg->AddChild( msgUI );
-
 }
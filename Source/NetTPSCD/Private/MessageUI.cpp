@@ -1,5 +1,16 @@
-// Fill out your copyright notice in the Description page of Project Settings.
+﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 
 #include "MessageUI.h"
 
+#include "Components/TextBlock.h"
+
+void UMessageUI::NativeOnListItemObjectSet( UObject* ListItemObject )
+{
+	IUserObjectListEntry::NativeOnListItemObjectSet( ListItemObject );
+
+	if (auto item = Cast<UChatMessageItem>( ListItemObject ))
+	{
+		txt_msg->SetText( FText::FromString( item->msg ) );
+	}
+}
@@ -0,0 +1,148 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetDebugSubsystem.h"
+
+#include "NetTPSCD.h"
+#include "Debug/DebugDrawService.h"
+#include "Engine/Canvas.h"
+#include "Engine/Engine.h"
+#include "GameFramework/Pawn.h"
+#include "GameFramework/PlayerController.h"
+
+#if NETTPSCD_NET_DEBUG
+static TAutoConsoleVariable<bool> CVarNetDebug(
+	TEXT( "NetTPSCD.NetDebug" ) ,
+	false ,
+	TEXT( "캐릭터와 NetTestActor 위에 Owner/Connection/Role 정보를 보여준다." ) );
+
+DECLARE_CYCLE_STAT( TEXT( "NetDebug Draw" ) , STAT_NetDebugDraw , STATGROUP_NetTPSCD );
+#endif
+
+bool UNetDebugSubsystem::ShouldCreateSubsystem( UObject* Outer ) const
+{
+#if NETTPSCD_NET_DEBUG
+	return Super::ShouldCreateSubsystem( Outer );
+#else
+	return false;
+#endif
+}
+
+bool UNetDebugSubsystem::IsEnabled()
+{
+#if NETTPSCD_NET_DEBUG
+	return CVarNetDebug.GetValueOnGameThread();
+#else
+	return false;
+#endif
+}
+
+void UNetDebugSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+#if NETTPSCD_NET_DEBUG
+	// 모든 액터의 글자를 한번의 캔버스 패스로 그리고싶다.
+	drawHandle = UDebugDrawService::Register( TEXT( "Game" ) , FDebugDrawDelegate::CreateUObject( this , &UNetDebugSubsystem::DrawOverlay ) );
+#endif
+}
+
+void UNetDebugSubsystem::Deinitialize()
+{
+#if NETTPSCD_NET_DEBUG
+	if (drawHandle.IsValid())
+	{
+		UDebugDrawService::Unregister( drawHandle );
+	}
+	entries.Reset();
+#endif
+
+	Super::Deinitialize();
+}
+
+void UNetDebugSubsystem::Register( AActor* actor )
+{
+#if NETTPSCD_NET_DEBUG
+	if (nullptr == actor || entries.ContainsByPredicate( [actor]( const FNetDebugEntry& entry ) { return entry.actor == actor; } ))
+		return;
+
+	FNetDebugEntry& entry = entries.AddDefaulted_GetRef();
+	entry.actor = actor;
+	RefreshText( entry );
+#endif
+}
+
+void UNetDebugSubsystem::Unregister( AActor* actor )
+{
+#if NETTPSCD_NET_DEBUG
+	entries.RemoveAllSwap( [actor]( const FNetDebugEntry& entry ) { return entry.actor == actor; } );
+#endif
+}
+
+void UNetDebugSubsystem::RefreshText( FNetDebugEntry& entry )
+{
+#if NETTPSCD_NET_DEBUG
+	AActor* actor = entry.actor.Get();
+	const APawn* pawn = Cast<APawn>( actor );
+
+	entry.owner = actor->GetOwner();
+	entry.bHasConnection = nullptr != actor->GetNetConnection();
+	entry.bLocallyControlled = pawn && pawn->IsLocallyControlled();
+	entry.localRole = actor->GetLocalRole();
+	entry.remoteRole = actor->GetRemoteRole();
+
+	// 오너가 있는가?
+	const FString owner = entry.owner.IsValid() ? entry.owner->GetName() : TEXT( "No Owner" );
+	// NetConnection이 있는가?
+	const TCHAR* conn = entry.bHasConnection ? TEXT( "Valid" ) : TEXT( "Invalid" );
+	const FString localRole = UEnum::GetValueAsString<ENetRole>( entry.localRole );
+	const FString remoteRole = UEnum::GetValueAsString<ENetRole>( entry.remoteRole );
+
+	entry.text = FString::Printf( TEXT( "Owner : %s\nConnection : %s\nlocalRole : %s\nremoteRole : %s" ) , *owner , conn , *localRole , *remoteRole );
+	if (pawn)
+	{
+		entry.text += FString::Printf( TEXT( "\nlocallyController : %s" ) , entry.bLocallyControlled ? TEXT( "Yes" ) : TEXT( "No" ) );
+	}
+#endif
+}
+
+void UNetDebugSubsystem::DrawOverlay( UCanvas* canvas , APlayerController* pc )
+{
+#if NETTPSCD_NET_DEBUG
+	if (false == CVarNetDebug.GetValueOnGameThread() || nullptr == canvas || nullptr == pc || pc->GetWorld() != GetWorld())
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_NetDebugDraw );
+
+	UFont* font = GEngine->GetSmallFont();
+	for (int32 i = entries.Num() - 1; i >= 0; i--)
+	{
+		FNetDebugEntry& entry = entries[i];
+		AActor* actor = entry.actor.Get();
+		if (nullptr == actor)
+		{
+			entries.RemoveAtSwap( i );
+			continue;
+		}
+
+		// 오너나 역할이 바뀌었을 때만 문자열을 다시 만든다.
+		const APawn* pawn = Cast<APawn>( actor );
+		if (entry.owner.Get() != actor->GetOwner() ||
+			entry.bHasConnection != (nullptr != actor->GetNetConnection()) ||
+			entry.bLocallyControlled != (pawn && pawn->IsLocallyControlled()) ||
+			entry.localRole != actor->GetLocalRole() ||
+			entry.remoteRole != actor->GetRemoteRole())
+		{
+			RefreshText( entry );
+		}
+
+		// 카메라 뒤에 있으면 그리지 않는다.
+		const FVector screen = canvas->Project( actor->GetActorLocation() + FVector( 0 , 0 , 50 ) );
+		if (screen.Z <= 0)
+			continue;
+
+		canvas->SetDrawColor( FColor::Yellow );
+		canvas->DrawText( font , entry.text , screen.X , screen.Y , 0.75f , 0.75f );
+	}
+#endif
+}
@@ -5,6 +5,7 @@
 
 #include "OnlineSessionSettings.h"
 #include "OnlineSubsystem.h"
+#include "Engine/LocalPlayer.h"
 #include "Online/OnlineSessionNames.h"
 
 void UNetGameInstance::Init()
@@ -22,14 +23,38 @@ void UNetGameInstance::Init()
 		sessionInterface->OnJoinSessionCompleteDelegates.AddUObject( this , &UNetGameInstance::OnMyJoinRoomComplete );
 
 		sessionInterface->OnDestroySessionCompleteDelegates.AddUObject( this , &UNetGameInstance::OnMyExitRoomComplete );
+
+		sessionInterface->OnRegisterPlayersCompleteDelegates.AddUObject( this , &UNetGameInstance::OnMyRegisterPlayersComplete );
+
+		sessionInterface->OnUnregisterPlayersCompleteDelegates.AddUObject( this , &UNetGameInstance::OnMyRegisterPlayersComplete );
 	}
 }
 
-bool UNetGameInstance::IsInRoom()
+void UNetGameInstance::RefreshInRoom()
 {
-	FUniqueNetIdPtr netID = GetWorld()->GetFirstLocalPlayerFromController()->GetUniqueNetIdForPlatformUser().GetUniqueNetId();
+	bool bNewInRoom = false;
+	ULocalPlayer* localPlayer = GetFirstGamePlayer();
+	if (sessionInterface.IsValid() && localPlayer && false == myRoomName.IsEmpty())
+	{
+		FUniqueNetIdPtr netID = localPlayer->GetUniqueNetIdForPlatformUser().GetUniqueNetId();
+		bNewInRoom = netID.IsValid() && sessionInterface->IsPlayerInSession( FName( *myRoomName ) , *netID );
+	}
 
-	return sessionInterface->IsPlayerInSession( FName(*myRoomName) , *netID );
+	// 바뀌었을 때만 알려주고싶다.
+	if (bInRoom != bNewInRoom)
+	{
+		bInRoom = bNewInRoom;
+		onRoomMembershipChanged.Broadcast( bInRoom );
+	}
+}
+
+void UNetGameInstance::OnMyRegisterPlayersComplete( FName sessionName , const TArray<FUniqueNetIdRef>& players , bool bWasSuccessful )
+{
+	// 내 방에 누군가 등록되거나 해제되었다면 나도 포함되는지 다시 검사한다.
+	if (sessionName.ToString() == myRoomName)
+	{
+		RefreshInRoom();
+	}
 }
 
 void UNetGameInstance::CreateRoom( int32 maxPlayerCount , FString roomName )
@@ -72,6 +97,7 @@ void UNetGameInstance::OnMyCreateRoomComplete( FName sessionName , bool bWasSucc
 	{
 		// 입장한 방의 이름을 기억하고싶다.
 		myRoomName = sessionName.ToString();
+		RefreshInRoom();
 		// 서버는 세계 여행을 떠나고싶다. 어디로???
 		FString url = TEXT( "/Game/Net/Maps/BattleMap?listen" );
 		GetWorld()->ServerTravel( url );
@@ -162,6 +188,7 @@ void UNetGameInstance::OnMyJoinRoomComplete( FName sessionName , EOnJoinSessionC
 	{
 		// 입장한 방의 이름을 기억하고싶다.
 		myRoomName = sessionName.ToString();
+		RefreshInRoom();
 
 		// 서버의 주소를 받아와서
 		FString url;
@@ -194,6 +221,8 @@ void UNetGameInstance::MultiExitRoom_Implementation()
 
 void UNetGameInstance::OnMyExitRoomComplete(FName sessionName, bool bWasSuccessful)
 {
+	RefreshInRoom();
+
 	// 플레이어는 LobbyMap으로 여행을 떠나고싶다.
 	auto pc = GetWorld()->GetFirstPlayerController();
 	FString url = TEXT( "/Game/Net/Maps/LobbyMap" );
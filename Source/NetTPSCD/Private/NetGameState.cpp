@@ -0,0 +1,125 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetGameState.h"
+
+#include "MainUI.h"
+#include "NetPlayerController.h"
+#include "NetTPSCD.h"
+#include "TextFilterSubsystem.h"
+#include "GameFramework/PlayerState.h"
+
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Chat Messages Accepted" ) , STAT_ChatAccepted , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Chat Messages Rate Limited" ) , STAT_ChatRateLimited , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Chat Batches Sent" ) , STAT_ChatBatches , STATGROUP_NetTPSCD );
+
+ANetGameState::ANetGameState()
+{
+	PrimaryActorTick.bCanEverTick = true;
+}
+
+void ANetGameState::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (false == HasAuthority())
+	{
+		// 클라이언트는 받기만 하므로 틱이 필요없다.
+		SetActorTickEnabled( false );
+	}
+}
+
+void ANetGameState::Tick( float DeltaSeconds )
+{
+	Super::Tick( DeltaSeconds );
+
+	// 네트워크 업데이트 주기마다 한번만 묶어서 보내고싶다.
+	const double now = GetWorld()->GetTimeSeconds();
+	if (pendingChat.Num() > 0 && now - lastChatFlushTime >= 1.0 / FMath::Max( NetUpdateFrequency , 1.0f ))
+	{
+		lastChatFlushTime = now;
+		FlushChat();
+	}
+}
+
+void ANetGameState::ServerSubmitChat( APlayerState* sender , const FString& msg )
+{
+	if (false == HasAuthority() || nullptr == sender)
+		return;
+
+	FString text = msg.TrimStartAndEnd().Left( maxChatLength );
+	if (text.IsEmpty())
+		return;
+
+	if (false == ConsumeChatToken( sender ))
+	{
+		INC_DWORD_STAT( STAT_ChatRateLimited );
+		return;
+	}
+
+	if (auto textFilter = UTextFilterSubsystem::Get( this ))
+	{
+		textFilter->Mask( text );
+	}
+	pendingChat.Add( MoveTemp( text ) );
+	INC_DWORD_STAT( STAT_ChatAccepted );
+}
+
+bool ANetGameState::ConsumeChatToken( APlayerState* sender )
+{
+	const double now = GetWorld()->GetTimeSeconds();
+	FChatBucket* bucket = chatBuckets.Find( sender );
+	if (nullptr == bucket)
+	{
+		// 나간 플레이어들의 토큰은 새 플레이어가 올 때 정리한다.
+		for (auto it = chatBuckets.CreateIterator(); it; ++it)
+		{
+			if (false == it.Key().IsValid())
+			{
+				it.RemoveCurrent();
+			}
+		}
+		bucket = &chatBuckets.Add( sender );
+		bucket->tokens = chatBurst;
+		bucket->time = now;
+	}
+
+	// 지난번 이후 흐른 시간만큼 토큰을 채우고싶다.
+	bucket->tokens = FMath::Min( bucket->tokens + static_cast<float>(now - bucket->time) * chatMessagesPerSecond , chatBurst );
+	bucket->time = now;
+
+	if (bucket->tokens < 1)
+		return false;
+
+	bucket->tokens -= 1;
+	return true;
+}
+
+void ANetGameState::FlushChat()
+{
+	if (pendingChat.Num() <= maxChatBatchSize)
+	{
+		MultiChatBatch( pendingChat );
+		pendingChat.Reset();
+	}
+	else
+	{
+		TArray<FString> batch( pendingChat.GetData() , maxChatBatchSize );
+		pendingChat.RemoveAt( 0 , maxChatBatchSize , false );
+		MultiChatBatch( batch );
+	}
+	INC_DWORD_STAT( STAT_ChatBatches );
+}
+
+void ANetGameState::MultiChatBatch_Implementation( const TArray<FString>& messages )
+{
+	// 내 채팅창에 차례대로 넣고싶다.
+	auto pc = Cast<ANetPlayerController>( GetWorld()->GetFirstPlayerController() );
+	if (nullptr == pc || nullptr == pc->mainUI)
+		return;
+
+	for (const FString& msg : messages)
+	{
+		pc->mainUI->RecvMsg( msg );
+	}
+}
@@ -4,6 +4,7 @@
 #include "NetPlayerAnimInstance.h"
 
 #include "NetTPSCDCharacter.h"
+#include "WeaponComponent.h"
 
 void UNetPlayerAnimInstance::NativeInitializeAnimation()
 {
@@ -12,46 +13,47 @@ void UNetPlayerAnimInstance::NativeInitializeAnimation()
 	player = Cast<ANetTPSCDCharacter>( GetOwningActor() );
 }
 
+// 게임스레드
 void UNetPlayerAnimInstance::NativeUpdateAnimation( float DeltaSeconds )
 {
 	Super::NativeUpdateAnimation( DeltaSeconds );
 
-	if (nullptr == player)
+	bValid = nullptr != player;
+	if (false == bValid)
 		return;
 
-	// speed, direction값을 채우고싶다.
-	const FVector velocity = player->GetVelocity();
+	// 캐릭터의 값은 여기서 한번만 읽어두고싶다.
+	velocity = player->GetVelocity();
+	actorRotation = player->GetActorQuat();
+	aimRotation = player->GetBaseAimRotation();
+	bHasPistol = player->weaponComp->HasWeapon();
+	// 플레이어의 bDie를 기억하고싶다.
+	bDie = player->IsDead();
+}
 
-	speed = FVector::DotProduct( velocity , player->GetActorForwardVector() );
+// 워커스레드 : 게임스레드의 객체에 접근하지 않는다.
+void UNetPlayerAnimInstance::NativeThreadSafeUpdateAnimation( float DeltaSeconds )
+{
+	Super::NativeThreadSafeUpdateAnimation( DeltaSeconds );
+
+	if (false == bValid)
+		return;
 
-	direction = FVector::DotProduct( velocity , player->GetActorRightVector() );
+	// speed, direction값을 채우고싶다.
+	speed = FVector::DotProduct( velocity , actorRotation.GetForwardVector() );
 
-	bHasPistol = player->bHasPistol;
+	direction = FVector::DotProduct( velocity , actorRotation.GetRightVector() );
 
 	// Player의 Pitch값을 가져와서 PitchAngle에 대입하고싶다.
-	pitchAngle = -player->GetBaseAimRotation().GetNormalized().Pitch;
-
 	// pitchAngle값을 -60 ~ 60안에 가두고싶다.
-	pitchAngle = FMath::Clamp( pitchAngle , -60 , 60 );
-
-	// 플레이어의 bDie를 기억하고싶다.
-	bDie = player->bDie;
-
-
-	//FVector	forwardVector = player->GetActorForwardVector();
-	//FVector direction = FVector( 1 , 1 , 0 );
-
-	//float dot = FVector::DotProduct( forwardVector , direction );
-	//float angle =  FMath::RadiansToDegrees( FMath::Acos( dot ) );
-	//// -180 ~ 180
-	//if (angle < 0)
-	//	angle = 360 + angle;
+	pitchAngle = FMath::Clamp( static_cast<float>(-aimRotation.GetNormalized().Pitch) , -60.0f , 60.0f );
 }
 
 void UNetPlayerAnimInstance::PlayFireAnimation()
 {
 	// 총을 잡고 있을때만 총쏘기 애니메이션을 하고싶다.
-	if (bHasPistol && fireMontage)
+	// 애님 업데이트를 기다리지 않고 지금 무기 상태를 보고싶다.
+	if (player && player->weaponComp->HasWeapon() && fireMontage)
 	{
 		Montage_Play( fireMontage );
 	}
@@ -59,7 +61,7 @@ void UNetPlayerAnimInstance::PlayFireAnimation()
 
 void UNetPlayerAnimInstance::PlayReloadAnimation()
 {
-	if (bHasPistol && reloadMontage)
+	if (player && player->weaponComp->HasWeapon() && reloadMontage)
 	{
 		Montage_Play( reloadMontage );
 	}
@@ -72,7 +74,7 @@ void UNetPlayerAnimInstance::AnimNotify_OnReloadFinished()
 		return;
 
 	// 서버에 InitAmmo를 해달라고 요청해야한다.
-	player->ServerInitAmmo();
+	player->weaponComp->ServerInitAmmo();
 }
 
 void UNetPlayerAnimInstance::AnimNotify_DieEnd()
@@ -4,6 +4,13 @@
 #include "NetPlayerController.h"
 
 #include "BattleGameMode.h"
+#include "HPBarLayerWidget.h"
+#include "MainUI.h"
+#include "NetGameState.h"
+#include "NetTPSCDCharacter.h"
+#include "TextFilterSubsystem.h"
+#include "WeaponComponent.h"
+#include "EngineUtils.h"
 #include "GameFramework/Character.h"
 #include "GameFramework/SpectatorPawn.h"
 
@@ -15,6 +22,134 @@ void ANetPlayerController::BeginPlay()
 	{
 		gm = Cast<ABattleGameMode>(GetWorld()->GetAuthGameMode());
 	}
+
+	// 화면 체력바 모드라면 체력바 레이어를 mainUI보다 뒤에 깔고싶다.
+	if (IsLocalController() && bScreenSpaceHPBars && nullptr == hpBarLayer)
+	{
+		TSubclassOf<UHPBarLayerWidget> layerClass = hpBarLayerFactory ? hpBarLayerFactory : TSubclassOf<UHPBarLayerWidget>( UHPBarLayerWidget::StaticClass() );
+		hpBarLayer = CreateWidget<UHPBarLayerWidget>( this , layerClass );
+		hpBarLayer->SetVisibility( ESlateVisibility::HitTestInvisible );
+		hpBarLayer->AddToViewport( -1 );
+
+		// 나보다 먼저 태어난 캐릭터들은 월드 체력바를 켜두었으므로 여기서 한번에 끄고싶다.
+		for (TActorIterator<ANetTPSCDCharacter> It( GetWorld() ); It; ++It)
+		{
+			It->SetScreenSpaceHPBar( true );
+		}
+	}
+
+	cosmeticTokens = cosmeticBurst;
+	cosmeticTokenTime = GetWorld()->GetTimeSeconds();
+}
+
+void ANetPlayerController::ServerSendChat_Implementation( const FString& msg )
+{
+	// 검사와 묶어보내기는 게임스테이트가 한다.
+	auto gs = GetWorld()->GetGameState<ANetGameState>();
+	if (gs)
+	{
+		gs->ServerSubmitChat( PlayerState , msg );
+	}
+}
+
+void ANetPlayerController::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	tasks.CancelAll( this );
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void ANetPlayerController::BenchChat( int32 count )
+{
+	if (nullptr == mainUI)
+	{
+		UE_LOG( LogTemp , Warning , TEXT( "BenchChat : mainUI가 없습니다." ) );
+		return;
+	}
+
+	const uint64 usedBefore = FPlatformMemory::GetStats().UsedPhysical;
+	const double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < count; i++)
+	{
+		mainUI->RecvMsg( FString::Printf( TEXT( "Bench : 메시지 %d" ) , i ) );
+	}
+	const double elapsedMs = (FPlatformTime::Seconds() - start) * 1000.0;
+	const int64 usedDelta = static_cast<int64>(FPlatformMemory::GetStats().UsedPhysical) - static_cast<int64>(usedBefore);
+
+	// 이후 프레임 시간은 stat unit 으로 확인한다.
+	UE_LOG( LogTemp , Warning , TEXT( "BenchChat : %d messages, %.2f ms total (%.4f ms/msg), memory %+.2f MB" ) ,
+		count , elapsedMs , elapsedMs / FMath::Max( count , 1 ) , usedDelta / (1024.0 * 1024.0) );
+}
+
+void ANetPlayerController::BenchTextFilter( int32 count )
+{
+	auto textFilter = UTextFilterSubsystem::Get( this );
+	if (nullptr == textFilter)
+		return;
+
+	const TArray<FString>& badWords = textFilter->badWords;
+	const FString sample = TEXT( "안녕하세요 오늘 경기 재밌었어요 바보같은 실수를 했네요 Good Game 다음판도 같이해요 똥개" );
+
+	// 예전 방식 : 부를 때마다 단어 목록을 만들고 단어마다 문장 전체를 훑는다.
+	int32 naiveHits = 0;
+	double start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < count; i++)
+	{
+		TArray<FString> words( badWords );
+		FString msg = sample;
+		for (int32 w = 0; w < words.Num(); w++)
+		{
+			if (msg.Contains( words[w] ))
+			{
+				naiveHits++;
+			}
+			msg = msg.Replace( *words[w] , TEXT( "**" ) );
+		}
+	}
+	const double naiveMs = (FPlatformTime::Seconds() - start) * 1000.0;
+
+	// FTextFilter : 미리 만든 오토마타로 한번만 훑는다.
+	int32 filterHits = 0;
+	start = FPlatformTime::Seconds();
+	for (int32 i = 0; i < count; i++)
+	{
+		FString msg = sample;
+		if (textFilter->Mask( msg ))
+		{
+			filterHits++;
+		}
+	}
+	const double filterMs = (FPlatformTime::Seconds() - start) * 1000.0;
+
+	UE_LOG( LogTemp , Warning , TEXT( "BenchTextFilter : %d words, %d runs, naive %.2f ms (hits %d), aho-corasick %.2f ms (hits %d)" ) ,
+		badWords.Num() , count , naiveMs , naiveHits , filterMs , filterHits );
+}
+
+void ANetPlayerController::ClientFireCosmetic_Implementation( ANetTPSCDCharacter* shooter , const FFireEvent& fireEvent )
+{
+	// 아직 내 쪽에 없는 캐릭터라면 보여줄 수 없다.
+	if (nullptr == shooter || nullptr == shooter->weaponComp)
+		return;
+
+	shooter->weaponComp->PlayFireCosmetic( fireEvent );
+}
+
+bool ANetPlayerController::ConsumeCosmeticToken()
+{
+	// 내 화면에서 보여주는 것은 대역폭을 쓰지 않는다.
+	if (IsLocalController())
+		return true;
+
+	// 지난번 이후 흐른 시간만큼 토큰을 채우고싶다.
+	const double now = GetWorld()->GetTimeSeconds();
+	cosmeticTokens = FMath::Min( cosmeticTokens + static_cast<float>(now - cosmeticTokenTime) * cosmeticEventsPerSecond , cosmeticBurst );
+	cosmeticTokenTime = now;
+
+	if (cosmeticTokens < 1)
+		return false;
+
+	cosmeticTokens -= 1;
+	return true;
 }
 
 void ANetPlayerController::ServerRetrySpectator_Implementation()
@@ -30,11 +165,8 @@ void ANetPlayerController::ServerRetrySpectator_Implementation()
 	Possess( spectator );
 	player->Destroy();
 	// 5초후에 다시 원래 플레이어로 시작하도록 처리하고싶다.
-	FTimerHandle handle;
-	GetWorldTimerManager().SetTimer( handle , [&]()
-	{
-		ServerRetry();
-	} , 5 , false );
+	// 여러번 요청해도 타이머는 하나만 걸리고, 컨트롤러가 없어지면 불리지 않는다.
+	tasks.Schedule( retryTask , this , &ANetPlayerController::ServerRetry , 5 , false );
 }
 
 // 이곳은 서버에서 호출되는 함수이다.
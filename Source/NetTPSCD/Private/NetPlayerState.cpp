@@ -5,10 +5,15 @@
 
 #include "NetGameInstance.h"
 
+FOnNetPlayerStateChanged ANetPlayerState::OnPlayerStateChanged;
+FOnNetPlayerStateChanged ANetPlayerState::OnPlayerStateRemoved;
+
 void ANetPlayerState::BeginPlay()
 {
 	Super::BeginPlay();
 
+	OnPlayerStateChanged.Broadcast( this );
+
 	// 내가 로컬플레이어라면
 	auto pc = GetPlayerController();
 	if (pc && pc->IsLocalController())
@@ -20,6 +25,33 @@ void ANetPlayerState::BeginPlay()
 	}
 }
 
+void ANetPlayerState::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	OnPlayerStateRemoved.Broadcast( this );
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void ANetPlayerState::OnRep_Score()
+{
+	Super::OnRep_Score();
+
+	OnPlayerStateChanged.Broadcast( this );
+}
+
+void ANetPlayerState::OnRep_PlayerName()
+{
+	Super::OnRep_PlayerName();
+
+	OnPlayerStateChanged.Broadcast( this );
+}
+
+void ANetPlayerState::AddScore( int32 amount )
+{
+	SetScore( GetScore() + amount );
+	OnRep_Score();
+}
+
 void ANetPlayerState::ServerSetNickname_Implementation(const FString& newNickmane)
 {
 	// 서버RPC함수에서 	
@@ -0,0 +1,108 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "NetRepPolicyComponent.h"
+
+#include "NetTPSCD.h"
+
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Dormant Props" ) , STAT_DormantProps , STATGROUP_NetTPSCD );
+
+UNetRepPolicyComponent::UNetRepPolicyComponent()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = false;
+}
+
+void UNetRepPolicyComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	AActor* owner = GetOwner();
+	if (false == owner->HasAuthority() || false == owner->GetIsReplicated())
+		return;
+
+	owner->NetCullDistanceSquared = FMath::Square( netCullDistance );
+	owner->NetUpdateFrequency = maxNetUpdateFrequency;
+	owner->MinNetUpdateFrequency = minNetUpdateFrequency;
+
+	lastChangeTime = GetWorld()->GetTimeSeconds();
+
+	// 매 프레임 검사할 필요는 없다.
+	SetComponentTickInterval( updateInterval );
+	SetComponentTickEnabled( true );
+}
+
+void UNetRepPolicyComponent::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	if (bDormant)
+	{
+		DEC_DWORD_STAT( STAT_DormantProps );
+		bDormant = false;
+	}
+
+	Super::EndPlay( EndPlayReason );
+}
+
+void UNetRepPolicyComponent::TickComponent( float DeltaTime , ELevelTick TickType , FActorComponentTickFunction* ThisTickFunction )
+{
+	Super::TickComponent( DeltaTime , TickType , ThisTickFunction );
+
+	AActor* owner = GetOwner();
+
+	// 초당 바뀌는 횟수를 부드럽게 구해서 그만큼만 보내고싶다.
+	const float rate = changeCount / FMath::Max( DeltaTime , KINDA_SMALL_NUMBER );
+	changeRate = FMath::Lerp( changeRate , rate , 0.5f );
+	changeCount = 0;
+	owner->NetUpdateFrequency = FMath::Clamp( changeRate , minNetUpdateFrequency , maxNetUpdateFrequency );
+
+	// 한동안 바뀐 것이 없거나, 가끔씩만 바뀌어서 바뀔 때마다 보내는 편이 싸다면 휴면시키고싶다.
+	const bool bIdle = GetWorld()->GetTimeSeconds() - lastChangeTime >= idleTimeBeforeDormant;
+	const bool bRareChanges = changeRate * flushChangeInterval <= 1.0f;
+	if (false == bDormant && (bIdle || bRareChanges))
+	{
+		SetDormant( true );
+	}
+}
+
+void UNetRepPolicyComponent::NotifyStateChanged()
+{
+	if (false == IsComponentTickEnabled())
+		return;
+
+	const double now = GetWorld()->GetTimeSeconds();
+	const bool bRareChange = now - lastChangeTime >= flushChangeInterval;
+	lastChangeTime = now;
+	changeCount++;
+
+	if (bDormant)
+	{
+		// 가끔 바뀌는 것은 깨우지 않고 바뀐 값만 한번 보내고 계속 휴면하고싶다.
+		// flushChangeInterval보다 자주 바뀌기 시작하면 깨운다.
+		if (bRareChange)
+		{
+			GetOwner()->FlushNetDormancy();
+		}
+		else
+		{
+			SetDormant( false );
+		}
+	}
+}
+
+void UNetRepPolicyComponent::SetDormant( bool bNewDormant )
+{
+	AActor* owner = GetOwner();
+	bDormant = bNewDormant;
+	if (bDormant)
+	{
+		owner->SetNetDormancy( DORM_DormantAll );
+		INC_DWORD_STAT( STAT_DormantProps );
+	}
+	else
+	{
+		// 깨어나자마자 바뀐 값을 보내고싶다.
+		owner->SetNetDormancy( DORM_Awake );
+		owner->ForceNetUpdate();
+		DEC_DWORD_STAT( STAT_DormantProps );
+	}
+}
@@ -7,18 +7,25 @@
 #include "GameFramework/CharacterMovementComponent.h"
 #include "GameFramework/SpringArmComponent.h"
 #include "GameFramework/Controller.h"
+#include "BillboardSubsystem.h"
 #include "EnhancedInputComponent.h"
 #include "EnhancedInputSubsystems.h"
 #include "HPBarWidget.h"
 #include "InputActionValue.h"
+#include "LagCompensationSubsystem.h"
 #include "MainUI.h"
+#include "NetDebugSubsystem.h"
 #include "NetPlayerAnimInstance.h"
 #include "NetPlayerController.h"
 #include "NetPlayerState.h"
+#include "ProximitySubsystem.h"
+#include "SignificanceSubsystem.h"
+#include "WeaponComponent.h"
 #include "Blueprint/UserWidget.h"
 #include "Components/WidgetComponent.h"
 #include "Kismet/GameplayStatics.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 DEFINE_LOG_CATEGORY( LogTemplateCharacter );
 DEFINE_LOG_CATEGORY( MyLog );
@@ -28,7 +35,8 @@ DEFINE_LOG_CATEGORY( MyLog );
 
 ANetTPSCDCharacter::ANetTPSCDCharacter()
 {
-	PrimaryActorTick.bCanEverTick = true;
+	// hpUIComp 빌보드는 UBillboardSubsystem이 처리하므로 캐릭터는 Tick이 필요없다.
+	PrimaryActorTick.bCanEverTick = false;
 
 	// Set size for collision capsule
 	GetCapsuleComponent()->InitCapsuleSize( 42.f , 96.0f );
@@ -75,6 +83,10 @@ ANetTPSCDCharacter::ANetTPSCDCharacter()
 	hpUIComp = CreateDefaultSubobject<UWidgetComponent>( TEXT( "hpUIComp" ) );
 	hpUIComp->SetupAttachment( RootComponent );
 
+	vitals.hp = static_cast<uint8>(maxHP);
+
+	weaponComp = CreateDefaultSubobject<UWeaponComponent>( TEXT( "weaponComp" ) );
+
 	bReplicates = true;
 	SetReplicateMovement( true );
 }
@@ -94,31 +106,109 @@ void ANetTPSCDCharacter::BeginPlay()
 			Subsystem->AddMappingContext( DefaultMappingContext , 0 );
 		}
 	}
+
+	// 네트워크 정보를 디버그 화면에 보여주고싶다.
+	if (auto netDebug = GetWorld()->GetSubsystem<UNetDebugSubsystem>())
+	{
+		netDebug->Register( this );
+	}
+
+	// 화면 체력바 레이어가 이미 있다면 hpUIComp는 그리지 않고, 아니라면 빌보드 처리 하고싶다.
+	// 레이어가 나중에 생기면 ANetPlayerController::BeginPlay에서 모든 캐릭터의 hpUIComp를 끈다.
+	auto localPC = Cast<ANetPlayerController>( GetWorld()->GetFirstPlayerController() );
+	SetScreenSpaceHPBar( localPC && localPC->hpBarLayer );
+
+	// 멀거나 안 보이면 애니메이션과 리플리케이트를 줄이고싶다.
+	if (auto significance = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+	{
+		significance->Register( this );
+	}
+
+	// 서버에서는 총알 판정을 위해 내 캡슐 자세를 기록하고싶다.
+	if (HasAuthority())
+	{
+		// 블루프린트에서 maxHP를 바꿨을 수 있으므로 체력을 가득 채우고싶다.
+		if (vitals.hp != maxHP)
+		{
+			vitals.hp = static_cast<uint8>(FMath::Clamp( maxHP , 1 , FCharacterVitals::MaxHP ));
+			MARK_PROPERTY_DIRTY_FROM_NAME( ANetTPSCDCharacter , vitals , this );
+		}
+
+		if (auto lagComp = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+		{
+			lagComp->Register( this );
+		}
+
+		// 가까이 온 플레이어를 오너로 삼는 소품들이 나를 찾을 수 있게 하고싶다.
+		if (auto proximity = GetWorld()->GetSubsystem<UProximitySubsystem>())
+		{
+			proximity->Register( this );
+		}
+	}
 }
 
-void ANetTPSCDCharacter::PossessedBy(AController* NewController)
+void ANetTPSCDCharacter::EndPlay( const EEndPlayReason::Type EndPlayReason )
 {
-	Super::PossessedBy(NewController);
+	if (auto lagComp = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+	{
+		lagComp->Unregister( this );
+	}
+	if (auto proximity = GetWorld()->GetSubsystem<UProximitySubsystem>())
+	{
+		proximity->Unregister( this );
+	}
+	if (auto netDebug = GetWorld()->GetSubsystem<UNetDebugSubsystem>())
+	{
+		netDebug->Unregister( this );
+	}
+	if (auto billboard = GetWorld()->GetSubsystem<UBillboardSubsystem>())
+	{
+		billboard->Unregister( hpUIComp );
+	}
+	if (auto significance = GetWorld()->GetSubsystem<USignificanceSubsystem>())
+	{
+		significance->Unregister( this );
+	}
 
-	InitUI();
+	Super::EndPlay( EndPlayReason );
 }
 
-void ANetTPSCDCharacter::Tick( float DeltaSeconds )
+void ANetTPSCDCharacter::SetScreenSpaceHPBar( bool bScreenSpace )
 {
-	Super::Tick( DeltaSeconds );
+	hpUIComp->SetVisibility( false == bScreenSpace );
+	hpUIComp->SetComponentTickEnabled( false == bScreenSpace );
 
-	PrintNetLog();
-
-	// hpUIComp를 빌보드 처리 하고싶다.
-	if (hpUIComp && hpUIComp->GetVisibleFlag())
+	if (auto billboard = GetWorld()->GetSubsystem<UBillboardSubsystem>())
 	{
-		auto cam = GetWorld()->GetFirstPlayerController()->PlayerCameraManager;
-		FVector dir = cam->GetCameraLocation() - hpUIComp->GetComponentLocation();
+		if (bScreenSpace)
+		{
+			billboard->Unregister( hpUIComp );
+		}
+		else
+		{
+			billboard->Register( hpUIComp );
+		}
+	}
+}
 
-		hpUIComp->SetWorldRotation( dir.GetSafeNormal2D().ToOrientationRotator() );
+void ANetTPSCDCharacter::PostInitializeComponents()
+{
+	Super::PostInitializeComponents();
+
+	// 블루프린트가 아직 예전 ExplosionVFXFactory만 가지고 있다면 기본 무기의 폭발VFX로 쓰고싶다.
+	if (ExplosionVFXFactory_DEPRECATED && weaponComp && nullptr == weaponComp->defaultWeapon.impactVFX)
+	{
+		weaponComp->defaultWeapon.impactVFX = ExplosionVFXFactory_DEPRECATED;
 	}
 }
 
+void ANetTPSCDCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	InitUI();
+}
+
 void ANetTPSCDCharacter::InitUI()
 {
 	// 태어날 때 hpUI를 가져오고싶다.
@@ -163,278 +253,80 @@ void ANetTPSCDCharacter::InitUI()
 	if (mainUI)
 	{
 		mainUI->hp = 1.0f;
-		mainUI->ReloadBulletUI( maxBulletCount );
+		mainUI->ReloadBulletUI( weaponComp->GetMaxBulletCount() );
 	}
 }
 
 void ANetTPSCDCharacter::PickupPistol( const FInputActionValue& Value )
 {
-	if (bHasPistol || isReload)
-		return;
-
-	// 가까운 총을 검색해서 
-	TArray<struct FOverlapResult> OutOverlaps;
-	FCollisionObjectQueryParams ObjectQueryParams( FCollisionObjectQueryParams::InitType::AllObjects );
-
-	bool bHits = GetWorld()->OverlapMultiByObjectType(
-		OutOverlaps ,
-		GetActorLocation() ,
-		FQuat::Identity ,
-		ObjectQueryParams ,
-		FCollisionShape::MakeSphere( findPistolRadius ) );
-
-	AActor* _tempGrabPistol = nullptr;
-	// 만약 검색된 결과 있다면
-	if (bHits)
-	{
-		// 전체 검색해서
-		for (auto result : OutOverlaps)
-		{
-			// 만약 액터의 오너가 없고 액터의 이름에 BP_Pistol이 포함되어있다면
-			AActor* _temp = result.GetActor();
-			if (nullptr == _temp->GetOwner() &&
-				_temp->GetActorNameOrLabel().Contains( TEXT( "BP_Pistol" ) ))
-			{
-				// 그것을 grabPistol로 하고싶다.
-				_tempGrabPistol = result.GetActor();
-				// 반복을 그만하고싶다.
-				break;
-			}
-		}
-	}
-
-	// 만약 _tempGrabPistol이 nullptr이 아니라면
-	// 서버에게 손에 붙여달라고 요청하고싶다.
-	if (_tempGrabPistol)
-	{
-		ServerAttachPistol( _tempGrabPistol );
-	}
+	weaponComp->PickupWeapon();
 }
 
-void ANetTPSCDCharacter::ServerAttachPistol_Implementation( AActor* pistol )
-{
-	MultiAttachPistol( pistol );
-}
-
-void ANetTPSCDCharacter::MultiAttachPistol_Implementation( AActor* pistol )
-{
-	grabPistol = pistol;
-	AttachPistol( pistol );
-	grabPistol->SetOwner( this );
-	bHasPistol = true;
-	isReload = false;
-	if (mainUI)
-	{
-		mainUI->SetActiveCrosshair( true );
-	}
-}
-bool ANetTPSCDCharacter::ServerDetachPistol_Validate( AActor* pistol )
-{
-	return true;
-}
-
-
 void ANetTPSCDCharacter::DropPistol( const FInputActionValue& Value )
 {
-	if (false == bHasPistol || isReload)
-		return;
-
-	ServerDetachPistol( grabPistol );
-}
-void ANetTPSCDCharacter::ServerDetachPistol_Implementation( AActor* pistol )
-{
-	MultiDetachPistol( pistol );
-}
-void ANetTPSCDCharacter::MultiDetachPistol_Implementation( AActor* pistol )
-{
-	bHasPistol = false;
-	DetachPistol( pistol );
-	if (mainUI)
-		mainUI->SetActiveCrosshair( false );
-}
-
-void ANetTPSCDCharacter::AttachPistol( const AActor* pistol )
-{
-	// pistol의 staticmeshcomponent를 가져오고싶다.
-	auto mesh = pistol->GetComponentByClass<UStaticMeshComponent>();
-	// pistol 물리를 끄고싶다.
-	mesh->SetSimulatePhysics( false );
-	// hand에 붙이고싶다.
-	mesh->AttachToComponent( handComp , FAttachmentTransformRules::SnapToTargetNotIncludingScale );
-}
-
-void ANetTPSCDCharacter::DetachPistol( const AActor* pistol )
-{
-	if (nullptr == grabPistol)
-		return;
-
-	// pistol의 staticmeshcomponent를 가져오고싶다.
-	auto mesh = pistol->GetComponentByClass<UStaticMeshComponent>();
-	// pistol 물리를 켜고싶다.
-	mesh->SetSimulatePhysics( true );
-	// hand에서 떼고싶다.
-	mesh->DetachFromComponent( FDetachmentTransformRules::KeepRelativeTransform );
-
-	grabPistol->SetOwner( nullptr );
-	grabPistol = nullptr;
+	weaponComp->DropWeapon();
 }
 
 void ANetTPSCDCharacter::Fire( const FInputActionValue& Value )
 {
-	// 내가 총을 가지고 있지 않다면 바로 함수 종료
-	// bulletCount가 0 이하라면 바로 함수 종료
-	if (false == bHasPistol || nullptr == grabPistol || bulletCount <= 0)
-		return;
-
-	// 만약 재장전 중이라면 함수를 바로 종료
-	if (isReload)
-		return;
-
-	ServerFire();
-
-}
-
-
-void ANetTPSCDCharacter::ServerFire_Implementation()
-{
-	// - 카메라위치에서 카메라 앞방향으로
-	FHitResult OutHit;
-	FVector Start = FollowCamera->GetComponentLocation();
-	FVector End = Start + FollowCamera->GetForwardVector() * 100000;
-	FCollisionQueryParams Params;
-	Params.AddIgnoredActor( this );
-	// 바라보고
-	bool bHit = GetWorld()->LineTraceSingleByChannel( OutHit , Start , End , ECollisionChannel::ECC_Visibility , Params );
-
-	if (bHit)
-	{
-		// 만약 부딪힌 상대방이 ANetTPSCDCharacter라면
-		// TakeDamage로 데미지를 1점 주고싶다.
-		auto otherPlayer = Cast<ANetTPSCDCharacter>( OutHit.GetActor() );
-		if (otherPlayer)
-		{
-			otherPlayer->OnMyTakeDamage( 1 );
-			// 나의 점수를 1점 증가시키고싶다.
-			auto ps = Cast<ANetPlayerController>( Controller )->GetPlayerState<ANetPlayerState>();
-			ps->SetScore( ps->GetScore() + 1 );
-		}
-	}
-
-	MultiFire( bHit , OutHit , bulletCount - 1 );
-
-}
-
-void ANetTPSCDCharacter::MultiFire_Implementation( bool bHit , const FHitResult& hitInfo , int32 newBulletCount )
-{
-	// 1개 차감하고
-	bulletCount = newBulletCount;
-	// 총알UI를 갱신하고싶다.
-	if (mainUI)
-	{
-		mainUI->RemoveBulletUI( bulletCount );
-	}
-
-	// UNetPlayerAnimInstance::PlayerFireAnimation를 호출하고싶다.
-	// 1. UNetPlayerAnimInstance를 가져오고싶다.
-	auto anim = Cast<UNetPlayerAnimInstance>( GetMesh()->GetAnimInstance() );
-	// 2. PlayerFireAnimation를 호출하고싶다.
-	anim->PlayFireAnimation();
-
-
-	// 만약 부딪힌곳이 있다면 
-	if (bHit)
-	{
-		// 그곳에 폭발VFX를 배치하고싶다.
-		UGameplayStatics::SpawnEmitterAtLocation( GetWorld() , ExplosionVFXFactory , hitInfo.ImpactPoint );
-
-
-	}
+	weaponComp->Fire();
 }
 
 void ANetTPSCDCharacter::Reload( const FInputActionValue& Value )
 {
-	// 만약 재장전 중이라면 함수를 바로 종료
-	if (isReload)
-		return;
-
-	ServerReload();
-}
-
-void ANetTPSCDCharacter::ServerReload_Implementation()
-{
-	MultiReload();
-}
-
-void ANetTPSCDCharacter::MultiReload_Implementation()
-{
-	isReload = true;
-	// 리로드 애니메이션을 재생.
-	auto anim = Cast<UNetPlayerAnimInstance>( GetMesh()->GetAnimInstance() );
-	anim->PlayReloadAnimation();
-}
-
-void ANetTPSCDCharacter::ServerInitAmmo_Implementation()
-{
-	bulletCount = maxBulletCount;
-	MultiInitAmmo();
+	weaponComp->Reload();
 }
 
-void ANetTPSCDCharacter::MultiInitAmmo_Implementation()
+bool FCharacterVitals::NetSerialize( FArchive& Ar , UPackageMap* Map , bool& bOutSuccess )
 {
-	InitAmmo();
-}
-
+	Ar.SerializeBits( &hp , HPBits );
 
-void ANetTPSCDCharacter::InitAmmo()
-{
-	if (mainUI)
-	{
-		mainUI->ReloadBulletUI( maxBulletCount );
-	}
-	isReload = false;
+	bOutSuccess = true;
+	return true;
 }
 
-
-void ANetTPSCDCharacter::OnRep_HP()
+void ANetTPSCDCharacter::OnRep_Vitals( const FCharacterVitals& oldVitals )
 {
 	// UI도 반영하고싶다.
-	float newHP = static_cast<float>(hp) / maxHP;
+	const float newHP = static_cast<float>(vitals.hp) / maxHP;
 	if (mainUI) // 내꺼
 	{
 		mainUI->hp = newHP;
-		mainUI->PlayHitAnim();
-
+		// 체력이 줄었을 때만 맞는 연출을 하고싶다.
+		if (vitals.hp < oldVitals.hp)
+		{
+			mainUI->PlayHitAnim();
+		}
 	}
-	else // 니꺼
+	else if (hpUI) // 니꺼
 	{
 		hpUI->hp = newHP;
 	}
-
 }
 
 int32 ANetTPSCDCharacter::GetHP()
 {
-	return hp;
+	return vitals.hp;
 }
 
 // 서버에서 호출됨.
 void ANetTPSCDCharacter::SetHP( int32 value )
 {
-	hp = value;
+	const FCharacterVitals oldVitals = vitals;
+	vitals.hp = static_cast<uint8>(FMath::Clamp( value , 0 , FCharacterVitals::MaxHP ));
+	MARK_PROPERTY_DIRTY_FROM_NAME( ANetTPSCDCharacter , vitals , this );
 
-	if (hp <= 0)
+	if (vitals.IsDead() && false == oldVitals.IsDead())
 	{
-		bDie = true;
 		// 총을 놓고싶다.
 		//DropPistol(FInputActionValue());
-		if (grabPistol)
-			MultiDetachPistol( grabPistol );
+		weaponComp->SetGrabWeapon( nullptr );
 
 		// 이동을 막고싶다.
 		GetCharacterMovement()->DisableMovement();
 	}
 
-	OnRep_HP();
+	OnRep_Vitals( oldVitals );
 }
 
 void ANetTPSCDCharacter::OnMyTakeDamage( int32 damage )
@@ -444,28 +336,6 @@ void ANetTPSCDCharacter::OnMyTakeDamage( int32 damage )
 	SetHP( newHP );
 }
 
-void ANetTPSCDCharacter::PrintNetLog()
-{
-	// 오너가 있는가?
-	FString owner = GetOwner() ? GetOwner()->GetName() : TEXT( "No Owner" );
-	// NetConnection이 있는가?
-	FString conn = GetNetConnection() ? TEXT( "Valid" ) : TEXT( "Invalid" );
-	// LocalRole
-	FString localRole = UEnum::GetValueAsString<ENetRole>( GetLocalRole() );
-	// RemoteRole
-	FString remoteRole = UEnum::GetValueAsString<ENetRole>( GetRemoteRole() );
-
-	FString locallyController = IsLocallyControlled() ? TEXT( "Yes" ) : TEXT( "No" );
-
-	FString str = FString::Printf( TEXT( "Owner : %s\nConnection : %s\nlocalRole : %s\nremoteRole : %s\nlocallyController : %s" ) , *owner , *conn , *localRole , *remoteRole, *locallyController );
-
-	FVector loc = GetActorLocation() + FVector( 0 , 0 , 50 );
-	DrawDebugString( GetWorld() , loc , str , nullptr , FColor::Yellow , 0 , false , 0.75f );
-
-}
-
-
-
 //////////////////////////////////////////////////////////////////////////
 // Input
 
@@ -586,26 +456,12 @@ void ANetTPSCDCharacter::ChatFlag(const FInputActionValue& Value)
 	}
 }
 
-void ANetTPSCDCharacter::ServerSendMsg_Implementation(const FString& msg)
-{
-	MultiSendMsg( msg );
-}
-
-void ANetTPSCDCharacter::MultiSendMsg_Implementation(const FString& msg)
-{
-	auto player = Cast<ANetTPSCDCharacter>(GetWorld()->GetFirstPlayerController()->GetPawn());
-	if (player && player->mainUI)
-	{
-		player->mainUI->RecvMsg( msg );
-	}
-}
-
 void ANetTPSCDCharacter::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME( ANetTPSCDCharacter , bHasPistol );
-	DOREPLIFETIME( ANetTPSCDCharacter , bulletCount );
-	DOREPLIFETIME( ANetTPSCDCharacter , hp );
-	DOREPLIFETIME( ANetTPSCDCharacter , bDie );
+	// SetHP에서 바뀔 때만 알려주므로 매 프레임 비교하지 않는다.
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST( ANetTPSCDCharacter , vitals , params );
 }
@@ -3,10 +3,16 @@
 
 #include "NetTestActor.h"
 
-#include "EngineUtils.h"
+#include "NetDebugSubsystem.h"
 #include "NetGameInstance.h"
+#include "NetRepPolicyComponent.h"
+#include "NetTPSCD.h"
 #include "NetTPSCDCharacter.h"
+#include "ProximitySubsystem.h"
+#include "DrawDebugHelpers.h"
+#include "GameFramework/GameStateBase.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
 
 // Sets default values
 ANetTestActor::ANetTestActor()
@@ -18,6 +24,8 @@ ANetTestActor::ANetTestActor()
 	SetRootComponent( meshComp );
 	meshComp->SetRelativeScale3D( FVector( 0.5f ) );
 
+	netPolicyComp = CreateDefaultSubobject<UNetRepPolicyComponent>( TEXT( "netPolicyComp" ) );
+
 	bReplicates = true;
 }
 
@@ -26,9 +34,34 @@ void ANetTestActor::BeginPlay()
 {
 	Super::BeginPlay();
 
-	NetUpdateFrequency = 100;
-
 	ChangeMatColor();
+
+	if (HasAuthority())
+	{
+		SetRotSpeed( rotSpeed );
+	}
+
+	// 네트워크 정보를 디버그 화면에 보여주고싶다.
+	if (auto netDebug = GetWorld()->GetSubsystem<UNetDebugSubsystem>())
+	{
+		netDebug->Register( this );
+	}
+}
+
+void ANetTestActor::EndPlay( const EEndPlayReason::Type EndPlayReason )
+{
+	tasks.CancelAll( this );
+	if (auto gi = GetGameInstance<UNetGameInstance>())
+	{
+		gi->onRoomMembershipChanged.Remove( roomMembershipHandle );
+	}
+
+	if (auto netDebug = GetWorld()->GetSubsystem<UNetDebugSubsystem>())
+	{
+		netDebug->Unregister( this );
+	}
+
+	Super::EndPlay( EndPlayReason );
 }
 
 // Called every frame
@@ -36,8 +69,6 @@ void ANetTestActor::Tick( float DeltaTime )
 {
 	Super::Tick( DeltaTime );
 
-	PrintNetLog();
-
 	FindOwner();
 
 	SelfRotation( DeltaTime );
@@ -45,147 +76,140 @@ void ANetTestActor::Tick( float DeltaTime )
 }
 
 
-void ANetTestActor::PrintNetLog()
+void ANetTestActor::FindOwner()
 {
-	// 오너가 있는가?
-	FString owner = GetOwner() ? GetOwner()->GetName() : TEXT( "No Owner" );
-	// NetConnection이 있는가?
-	FString conn = GetNetConnection() ? TEXT( "Valid" ) : TEXT( "Invalid" );
-	// LocalRole
-	FString localRole = UEnum::GetValueAsString<ENetRole>( GetLocalRole() );
-	// RemoteRole
-	FString remoteRole = UEnum::GetValueAsString<ENetRole>( GetRemoteRole() );
+#if NETTPSCD_NET_DEBUG
+	if (UNetDebugSubsystem::IsEnabled())
+	{
+		DrawDebugSphere( GetWorld() , GetActorLocation() , detectRadius , 16 , FColor::Cyan , false , 0 );
+	}
+#endif
 
-	FString str = FString::Printf( TEXT( "Owner : %s\nConnection : %s\nlocalRole : %s\nremoteRole : %s" ) , *owner , *conn , *localRole , *remoteRole );
+	// detectRadius안에 있는 ANetTPSCDCharacter 중에서 가장 까가운녀석을 내 오너로 하고싶다.
+	// 매 프레임 모든 캐릭터를 검사하지 않고 ownerCheckInterval마다 UProximitySubsystem에게 물어본다.
+	if (false == HasAuthority())
+		return;
 
-	FVector loc = GetActorLocation() + FVector( 0 , 0 , 50 );
-	DrawDebugString( GetWorld() , loc , str , nullptr , FColor::Yellow , 0 , false , 0.75f );
+	const double now = GetWorld()->GetTimeSeconds();
+	if (now < nextOwnerCheckTime)
+		return;
+	nextOwnerCheckTime = now + ownerCheckInterval;
 
-}
+	auto proximity = GetWorld()->GetSubsystem<UProximitySubsystem>();
+	if (nullptr == proximity)
+		return;
 
-void ANetTestActor::FindOwner()
-{
-	DrawDebugSphere( GetWorld() , GetActorLocation() , detectRadius , 32 , FColor::Cyan , false , 0 );
+	const FVector location = GetActorLocation();
+	float nearestDist = detectRadius;
+	AActor* NewOwner = proximity->FindNearestCharacter( location , detectRadius , &nearestDist );
 
-	// 레벨에 있는 ANetTPSCDCharacter 객체들을 다 검사해서 detectRadius안에 있고 그중에서도 가장 까가운녀석을 내 오너로 하고싶다.
-	if (HasAuthority())
+	// 지금 오너가 조금 벗어났거나 다른 플레이어가 조금 더 가까운 정도라면 그대로 두고싶다.
+	AActor* currentOwner = GetOwner();
+	if (currentOwner && NewOwner != currentOwner)
 	{
-		AActor* NewOwner = nullptr;
-		float tempDist = detectRadius;
-		for (TActorIterator<ANetTPSCDCharacter> It( GetWorld() ); It; ++It)
-		{
-			ANetTPSCDCharacter* player = *It;
-			// 상대방과 나의 거리를 측정해서
-			float temp = player->GetDistanceTo( this );
-			// 만약 temp가 tempDist보다 가깝다면
-			if (temp < tempDist)
-			{
-				// NewOwner로 기억하고싶다.
-				NewOwner = player;
-				// tempDist = temp;
-				tempDist = temp;
-			}
-		}
-		if (GetOwner() != NewOwner)
+		const float ownerDist = FVector::Dist( location , currentOwner->GetActorLocation() );
+		if (ownerDist <= detectRadius + ownerHysteresis && (nullptr == NewOwner || nearestDist + ownerHysteresis > ownerDist))
 		{
-			SetOwner( NewOwner );
+			NewOwner = currentOwner;
 		}
 	}
+
+	if (currentOwner != NewOwner && now - lastOwnerChangeTime >= minOwnerHoldTime)
+	{
+		SetOwner( NewOwner );
+		lastOwnerChangeTime = now;
+		netPolicyComp->NotifyStateChanged();
+	}
 }
 
 
 void ANetTestActor::SelfRotation( const float& DeltaTime )
 {
-	// 회전
-	// 만약 서버라면
-	if (HasAuthority())
+	// 서버든 클라든 서버 시간으로 회전값을 계산해서 반영하고싶다.
+	auto gs = GetWorld()->GetGameState();
+	if (nullptr == gs || motion.angularSpeed == 0)
 	{
-		//  : 실제로 회전하고 그 결과를 rotYaw변수에 담고싶다.
-		AddActorWorldRotation( FRotator( 0 , 360 * DeltaTime , 0 ) );
-		rotYaw = GetActorRotation().Yaw;
+		return;
 	}
-	// 그렇지않고 클라라면
-	else
-	{
-		currentTime += DeltaTime;
-
-		if (latestTime < KINDA_SMALL_NUMBER)
-		{
-			return;
-		}
 
-		// 비율값을 구하고싶다.
-		float alpha = currentTime / latestTime;
-		float newYaw = rotYaw + 360 * latestTime;
-		// 시작값, 끝값
-		float lerpYaw = FMath::Lerp<float>( rotYaw , newYaw , alpha );
-
-		//  현재 회전값의 Yaw값을 rotYaw값으로 반영하고싶다.
-		FRotator rot = GetActorRotation();
-		rot.Yaw = lerpYaw;
-		SetActorRotation( rot );
-	}
+	SetActorRotation( motion.Evaluate( gs->GetServerWorldTimeSeconds() ) );
 }
 
-// OnRep_RotYaw함수가 호출되면
-void ANetTestActor::OnRep_RotYaw()
+void ANetTestActor::SetRotSpeed( float newRotSpeed )
 {
-	// 최근시간에 현재시간값을 담는다.
-	latestTime = currentTime;
-	// 현재시간을 다시 0으로 초기화한다.
-	currentTime = 0;
+	rotSpeed = newRotSpeed;
+	// 속도가 그대로면 보낼 것이 없다.
+	if (motion.angularSpeed == newRotSpeed)
+	{
+		return;
+	}
+
+	// 지금 회전에서 새 속도로 다시 시작한다.
+	auto gs = GetWorld()->GetGameState();
+	motion.startTime = gs ? gs->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	motion.startRotation = GetActorRotation();
+	motion.axis = FVector::UpVector;
+	motion.angularSpeed = newRotSpeed;
+	MARK_PROPERTY_DIRTY_FROM_NAME( ANetTestActor , motion , this );
+	netPolicyComp->NotifyStateChanged();
 }
 
 void ANetTestActor::ChangeMatColor()
 {
 	// 재질을 dynamic으로 다시 만들고 싶다.
 	mat = meshComp->CreateDynamicMaterialInstance( 0 );
-	auto gi = GetGameInstance<UNetGameInstance>();
+	// 늦게 만들어진 재질에도 이미 받은 색을 반영하고싶다.
+	if (matColor.A > 0)
+	{
+		OnRep_MatColor();
+	}
 
 	// 서버에서
 	if (HasAuthority())
 	{
-		// 타이머를 이용해서 1초마다 색을 바꾸고싶다.
-		// 타이머로 람다식, 무명함수
-		FTimerHandle handle;
-		GetWorldTimerManager().SetTimer( handle , [&, gi]()
+		// 매초 방에 있는지 물어보지 않고 들어가고 나올 때만 알려달라고 하고싶다.
+		auto gi = GetGameInstance<UNetGameInstance>();
+		if (gi)
 		{
-			//OnRep_ChangeMatColor();
-			if (gi->IsInRoom())
-			{
-				matColor = FLinearColor::MakeRandomColor();
-				ServerChangeMatColor( matColor );
-			}
-		} , 1 , true );
+			roomMembershipHandle = gi->onRoomMembershipChanged.AddUObject( this , &ANetTestActor::OnRoomMembershipChanged );
+			OnRoomMembershipChanged( gi->IsInRoom() );
+		}
 	}
 }
 
-//void ANetTestActor::OnRep_ChangeMatColor()
-//{
-//	if (mat)
-//	{
-//		mat->SetVectorParameterValue( TEXT( "FloorColor" ) , matColor );
-//	}
-//}
+void ANetTestActor::OnRoomMembershipChanged( bool bInRoom )
+{
+	if (bInRoom)
+	{
+		// 타이머를 이용해서 matColorInterval마다 색을 바꾸고싶다.
+		tasks.Schedule( matColorTask , this , &ANetTestActor::OnChangeMatColorTimer , matColorInterval , true );
+	}
+	else
+	{
+		tasks.Cancel( matColorTask , this );
+	}
+}
 
-void ANetTestActor::ServerChangeMatColor_Implementation( FLinearColor color )
+void ANetTestActor::OnChangeMatColorTimer()
 {
-	MulticastChangeMatColor( color );
+	SetMatColor( FLinearColor::MakeRandomColor() );
 }
 
-void ANetTestActor::ClientChangeMatColor_Implementation( FLinearColor color )
+void ANetTestActor::SetMatColor( const FLinearColor& color )
 {
-	if (mat)
-	{
-		mat->SetVectorParameterValue( TEXT( "FloorColor" ) , color );
-	}
+	matColor = color;
+	MARK_PROPERTY_DIRTY_FROM_NAME( ANetTestActor , matColor , this );
+	netPolicyComp->NotifyStateChanged();
+
+	// 리슨서버는 OnRep이 호출되지 않으므로 직접 호출한다.
+	OnRep_MatColor();
 }
 
-void ANetTestActor::MulticastChangeMatColor_Implementation(FLinearColor color)
+void ANetTestActor::OnRep_MatColor()
 {
 	if (mat)
 	{
-		mat->SetVectorParameterValue( TEXT( "FloorColor" ) , color );
+		mat->SetVectorParameterValue( TEXT( "FloorColor" ) , matColor );
 	}
 }
 
@@ -193,6 +217,8 @@ void ANetTestActor::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLi
 {
 	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
 
-	DOREPLIFETIME( ANetTestActor , rotYaw );
-	//DOREPLIFETIME( ANetTestActor , matColor );
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST( ANetTestActor , motion , params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( ANetTestActor , matColor , params );
 }
@@ -0,0 +1,201 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "PickupSubsystem.h"
+
+#include "EngineUtils.h"
+#include "Components/StaticMeshComponent.h"
+
+static const FName PickupTag( TEXT( "Pickup" ) );
+
+void UPickupSubsystem::OnWorldBeginPlay( UWorld& InWorld )
+{
+	Super::OnWorldBeginPlay( InWorld );
+
+	// 레벨에 배치된 총들을 한번만 등록하고 이후에는 생성될 때 등록하고싶다.
+	for (TActorIterator<AActor> It( &InWorld ); It; ++It)
+	{
+		OnActorSpawned( *It );
+	}
+	actorSpawnedHandle = InWorld.AddOnActorSpawnedHandler( FOnActorSpawned::FDelegate::CreateUObject( this , &UPickupSubsystem::OnActorSpawned ) );
+}
+
+void UPickupSubsystem::Deinitialize()
+{
+	if (actorSpawnedHandle.IsValid())
+	{
+		GetWorld()->RemoveOnActorSpawnedHandler( actorSpawnedHandle );
+	}
+
+	cells.Reset();
+	pickupCells.Reset();
+	movingPickups.Reset();
+
+	Super::Deinitialize();
+}
+
+void UPickupSubsystem::Tick( float DeltaTime )
+{
+	Super::Tick( DeltaTime );
+
+	// 떨어지는 총들의 칸을 갱신하고 멈추면 목록에서 빼고싶다.
+	for (int32 i = movingPickups.Num() - 1; i >= 0; i--)
+	{
+		const FPickupEntry& entry = movingPickups[i];
+		AActor* pickup = entry.actor.Get();
+		USceneComponent* body = entry.body.Get();
+		if (nullptr == pickup || nullptr == body || false == pickupCells.Contains( entry.actor ))
+		{
+			movingPickups.RemoveAtSwap( i );
+			continue;
+		}
+
+		const FIntVector cell = ToCell( body->GetComponentLocation() );
+		if (pickupCells[entry.actor] != cell)
+		{
+			RemoveFromCell( pickup );
+			InsertToCell( entry , cell );
+		}
+
+		if (body->GetComponentVelocity().SizeSquared() < 1.0f)
+		{
+			movingPickups.RemoveAtSwap( i );
+		}
+	}
+}
+
+TStatId UPickupSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( UPickupSubsystem , STATGROUP_Tickables );
+}
+
+void UPickupSubsystem::AddPickup( AActor* pickup )
+{
+	if (nullptr == pickup)
+		return;
+
+	FPickupEntry entry;
+	entry.actor = pickup;
+	entry.body = pickup->GetComponentByClass<UStaticMeshComponent>();
+	if (false == entry.body.IsValid())
+	{
+		entry.body = pickup->GetRootComponent();
+	}
+	if (false == entry.body.IsValid())
+		return;
+
+	RemoveFromCell( pickup );
+	InsertToCell( entry , ToCell( entry.body->GetComponentLocation() ) );
+	pickup->OnDestroyed.AddUniqueDynamic( this , &UPickupSubsystem::OnPickupDestroyed );
+
+	// 손에서 뗀 총은 물리로 떨어지므로 멈출 때까지 따라가고싶다.
+	movingPickups.Add( entry );
+}
+
+void UPickupSubsystem::RemovePickup( AActor* pickup )
+{
+	RemoveFromCell( pickup );
+}
+
+AActor* UPickupSubsystem::FindNearestPickup( const FVector& location , float radius ) const
+{
+	// 반경에 걸치는 칸들만 검사하고싶다.
+	const FIntVector minCell = ToCell( location - FVector( radius ) );
+	const FIntVector maxCell = ToCell( location + FVector( radius ) );
+
+	AActor* nearest = nullptr;
+	double nearestDistSq = FMath::Square( radius );
+	for (int32 x = minCell.X; x <= maxCell.X; x++)
+	{
+		for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+		{
+			for (int32 z = minCell.Z; z <= maxCell.Z; z++)
+			{
+				const auto* cell = cells.Find( FIntVector( x , y , z ) );
+				if (nullptr == cell)
+					continue;
+
+				for (const FPickupEntry& entry : *cell)
+				{
+					AActor* pickup = entry.actor.Get();
+					const USceneComponent* body = entry.body.Get();
+					if (nullptr == pickup || nullptr == body || pickup->GetOwner())
+						continue;
+
+					const double distSq = FVector::DistSquared( location , body->GetComponentLocation() );
+					if (distSq < nearestDistSq)
+					{
+						nearest = pickup;
+						nearestDistSq = distSq;
+					}
+				}
+			}
+		}
+	}
+	return nearest;
+}
+
+bool UPickupSubsystem::IsPickupActor( const AActor* actor ) const
+{
+	if (nullptr == actor)
+		return false;
+
+	if (actor->ActorHasTag( PickupTag ))
+		return true;
+
+	// 블루프린트 총은 태그가 없으므로 클래스 이름으로 판단하되 클래스마다 한번만 검사한다.
+	const UClass* actorClass = actor->GetClass();
+	if (const bool* cached = pickupClassCache.Find( actorClass ))
+		return *cached;
+
+	bool bPickup = false;
+	for (const UClass* c = actorClass; c && false == bPickup; c = c->GetSuperClass())
+	{
+		bPickup = c->GetName().StartsWith( TEXT( "BP_Pistol" ) );
+	}
+	pickupClassCache.Add( actorClass , bPickup );
+	return bPickup;
+}
+
+void UPickupSubsystem::OnActorSpawned( AActor* actor )
+{
+	if (IsPickupActor( actor ) && nullptr == actor->GetOwner())
+	{
+		AddPickup( actor );
+	}
+}
+
+void UPickupSubsystem::OnPickupDestroyed( AActor* destroyedActor )
+{
+	RemoveFromCell( destroyedActor );
+}
+
+FIntVector UPickupSubsystem::ToCell( const FVector& location ) const
+{
+	return FIntVector(
+		FMath::FloorToInt32( location.X / CellSize ) ,
+		FMath::FloorToInt32( location.Y / CellSize ) ,
+		FMath::FloorToInt32( location.Z / CellSize ) );
+}
+
+void UPickupSubsystem::InsertToCell( const FPickupEntry& entry , const FIntVector& cell )
+{
+	cells.FindOrAdd( cell ).Add( entry );
+	pickupCells.Add( entry.actor , cell );
+}
+
+void UPickupSubsystem::RemoveFromCell( AActor* pickup )
+{
+	FIntVector cell;
+	if (false == pickupCells.RemoveAndCopyValue( pickup , cell ))
+		return;
+
+	if (auto* entries = cells.Find( cell ))
+	{
+		entries->RemoveAllSwap( [pickup]( const FPickupEntry& entry ) { return entry.actor == pickup; } );
+		if (entries->Num() == 0)
+		{
+			cells.Remove( cell );
+		}
+	}
+}
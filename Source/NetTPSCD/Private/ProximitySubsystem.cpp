@@ -0,0 +1,119 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ProximitySubsystem.h"
+
+#include "NetTPSCD.h"
+#include "NetTPSCDCharacter.h"
+
+DECLARE_CYCLE_STAT( TEXT( "Proximity Rebuild" ) , STAT_ProximityRebuild , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Proximity Queries" ) , STAT_ProximityQueries , STATGROUP_NetTPSCD );
+
+void UProximitySubsystem::Deinitialize()
+{
+	characters.Reset();
+	entries.Reset();
+	cellRanges.Reset();
+
+	Super::Deinitialize();
+}
+
+void UProximitySubsystem::Register( ANetTPSCDCharacter* character )
+{
+	if (character)
+	{
+		characters.AddUnique( character );
+		builtFrame = MAX_uint64;
+	}
+}
+
+void UProximitySubsystem::Unregister( ANetTPSCDCharacter* character )
+{
+	characters.RemoveSwap( character );
+	builtFrame = MAX_uint64;
+}
+
+ANetTPSCDCharacter* UProximitySubsystem::FindNearestCharacter( const FVector& location , float radius , float* outDistance ) const
+{
+	INC_DWORD_STAT( STAT_ProximityQueries );
+	RebuildIfNeeded();
+
+	// 반경에 걸치는 칸들만 검사하고싶다.
+	const FIntVector minCell = ToCell( location - FVector( radius ) );
+	const FIntVector maxCell = ToCell( location + FVector( radius ) );
+
+	ANetTPSCDCharacter* nearest = nullptr;
+	double nearestDistSq = FMath::Square( radius );
+	for (int32 x = minCell.X; x <= maxCell.X; x++)
+	{
+		for (int32 y = minCell.Y; y <= maxCell.Y; y++)
+		{
+			for (int32 z = minCell.Z; z <= maxCell.Z; z++)
+			{
+				const auto* range = cellRanges.Find( FIntVector( x , y , z ) );
+				if (nullptr == range)
+					continue;
+
+				for (int32 i = range->Key; i < range->Key + range->Value; i++)
+				{
+					const double distSq = FVector::DistSquared( location , entries[i].location );
+					if (distSq < nearestDistSq)
+					{
+						nearest = entries[i].character;
+						nearestDistSq = distSq;
+					}
+				}
+			}
+		}
+	}
+
+	if (outDistance)
+	{
+		*outDistance = nearest ? FMath::Sqrt( static_cast<float>(nearestDistSq) ) : radius;
+	}
+	return nearest;
+}
+
+FIntVector UProximitySubsystem::ToCell( const FVector& location ) const
+{
+	return FIntVector(
+		FMath::FloorToInt32( location.X / CellSize ) ,
+		FMath::FloorToInt32( location.Y / CellSize ) ,
+		FMath::FloorToInt32( location.Z / CellSize ) );
+}
+
+void UProximitySubsystem::RebuildIfNeeded() const
+{
+	if (builtFrame == GFrameCounter)
+		return;
+
+	SCOPE_CYCLE_COUNTER( STAT_ProximityRebuild );
+	builtFrame = GFrameCounter;
+
+	// 캐릭터들의 위치를 한번만 모아서
+	entries.Reset();
+	for (const TWeakObjectPtr<ANetTPSCDCharacter>& weak : characters)
+	{
+		ANetTPSCDCharacter* character = weak.Get();
+		if (nullptr == character)
+			continue;
+
+		const FVector location = character->GetActorLocation();
+		entries.Add( { character , location , ToCell( location ) } );
+	}
+
+	// 같은 칸끼리 붙도록 정렬하고 칸마다 범위를 기억하고싶다.
+	entries.Sort( []( const FProximityEntry& a , const FProximityEntry& b )
+	{
+		if (a.cell.X != b.cell.X) return a.cell.X < b.cell.X;
+		if (a.cell.Y != b.cell.Y) return a.cell.Y < b.cell.Y;
+		return a.cell.Z < b.cell.Z;
+	} );
+
+	cellRanges.Reset();
+	for (int32 i = 0; i < entries.Num(); i++)
+	{
+		TPair<int32 , int32>& range = cellRanges.FindOrAdd( entries[i].cell , TPair<int32 , int32>( i , 0 ) );
+		range.Value++;
+	}
+}
@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ScheduledTasks.h"
+
+#include "Engine/World.h"
+
+void FScheduledTasks::Schedule( int32& task , UObject* owner , FTimerDelegate&& delegate , float rate , bool bLoop )
+{
+	UWorld* world = owner ? owner->GetWorld() : nullptr;
+	if (nullptr == world)
+		return;
+
+	FTimerManager& timerManager = world->GetTimerManager();
+	if (false == handles.IsValidIndex( task ))
+	{
+		task = AllocSlot();
+	}
+
+	// 같은 핸들로 다시 걸면 FTimerManager가 이전 타이머를 지우고 새로 건다.
+	timerManager.SetTimer( handles[task] , MoveTemp( delegate ) , rate , bLoop );
+}
+
+void FScheduledTasks::Cancel( int32& task , const UObject* owner )
+{
+	if (handles.IsValidIndex( task ))
+	{
+		if (UWorld* world = owner ? owner->GetWorld() : nullptr)
+		{
+			world->GetTimerManager().ClearTimer( handles[task] );
+		}
+		handles[task].Invalidate();
+	}
+	task = INDEX_NONE;
+}
+
+bool FScheduledTasks::IsScheduled( int32 task , const UObject* owner ) const
+{
+	const UWorld* world = owner ? owner->GetWorld() : nullptr;
+	return world && handles.IsValidIndex( task ) && world->GetTimerManager().TimerExists( handles[task] );
+}
+
+void FScheduledTasks::CancelAll( const UObject* owner )
+{
+	UWorld* world = owner ? owner->GetWorld() : nullptr;
+	for (FTimerHandle& handle : handles)
+	{
+		if (world)
+		{
+			world->GetTimerManager().ClearTimer( handle );
+		}
+		handle.Invalidate();
+	}
+}
+
+int32 FScheduledTasks::AllocSlot()
+{
+	// 취소된 칸은 다시 쓴다. 끝난 칸은 그 task를 들고 있는 쪽이 다시 Schedule할 때 쓴다.
+	for (int32 i = 0; i < handles.Num(); i++)
+	{
+		if (false == handles[i].IsValid())
+		{
+			return i;
+		}
+	}
+	return handles.AddDefaulted();
+}
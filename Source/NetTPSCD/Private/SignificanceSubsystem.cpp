@@ -0,0 +1,195 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SignificanceSubsystem.h"
+
+#include "NetTPSCD.h"
+#include "NetTPSCDCharacter.h"
+#include "Camera/PlayerCameraManager.h"
+#include "Components/SkeletalMeshComponent.h"
+#include "GameFramework/PlayerController.h"
+
+DECLARE_CYCLE_STAT( TEXT( "Significance Update" ) , STAT_SignificanceUpdate , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Significance High" ) , STAT_SignificanceHigh , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Significance Medium" ) , STAT_SignificanceMedium , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "Significance Low" ) , STAT_SignificanceLow , STATGROUP_NetTPSCD );
+
+USignificanceSubsystem::USignificanceSubsystem()
+{
+	// 가까움 / 보통 / 멀거나 안보임
+	FSignificanceBucket high;
+	high.maxDistance = 1500;
+	high.bAllowHidden = true;
+	buckets.Add( high );
+
+	FSignificanceBucket medium;
+	medium.maxDistance = 4000;
+	medium.tickInterval = 1.0f / 30;
+	medium.netUpdateScale = 0.5f;
+	medium.netPriorityScale = 0.75f;
+	buckets.Add( medium );
+
+	FSignificanceBucket low;
+	low.maxDistance = TNumericLimits<float>::Max();
+	low.bAllowHidden = true;
+	low.tickInterval = 1.0f / 10;
+	low.netUpdateScale = 0.2f;
+	low.netPriorityScale = 0.5f;
+	buckets.Add( low );
+}
+
+void USignificanceSubsystem::Deinitialize()
+{
+	entries.Reset();
+
+	Super::Deinitialize();
+}
+
+void USignificanceSubsystem::Tick( float DeltaTime )
+{
+	Super::Tick( DeltaTime );
+
+	// 매 프레임 할 필요는 없다.
+	updateTime += DeltaTime;
+	if (updateTime < updateInterval || buckets.Num() == 0)
+		return;
+	updateTime = 0;
+
+	SCOPE_CYCLE_COUNTER( STAT_SignificanceUpdate );
+
+	const bool bServer = GetWorld()->GetNetMode() < NM_Client;
+	FVector camLoc = FVector::ZeroVector;
+	auto pc = GetWorld()->GetFirstPlayerController();
+	const bool bHasCamera = pc && pc->IsLocalController() && pc->PlayerCameraManager;
+	if (bHasCamera)
+	{
+		camLoc = pc->PlayerCameraManager->GetCameraLocation();
+	}
+
+	int32 counts[3] = { 0 , 0 , 0 };
+	for (int32 i = entries.Num() - 1; i >= 0; i--)
+	{
+		FSignificanceEntry& entry = entries[i];
+		ANetTPSCDCharacter* character = entry.character.Get();
+		if (nullptr == character)
+		{
+			entries.RemoveAtSwap( i );
+			continue;
+		}
+
+		// 빙의는 BeginPlay 뒤에 일어나므로 내 캐릭터인지는 매번 확인한다.
+		// 내 캐릭터가 아니라면 화면 크기에 따라 애니메이션을 건너뛰게 하고싶다. (URO)
+		const bool bLocal = character->IsLocallyControlled();
+		character->GetMesh()->bEnableUpdateRateOptimizations = false == bLocal;
+
+		const FVector location = character->GetActorLocation();
+		const double viewerDistSq = bServer ? CalcViewerDistSq( character ) : TNumericLimits<double>::Max();
+
+		// 애니메이션은 내 화면에서 얼마나 가깝고 보이는지로 정하고싶다.
+		// 화면이 없는 데디케이트 서버는 보는 플레이어들과의 거리로 정한다.
+		int32 bucket = 0;
+		if (false == bLocal)
+		{
+			bucket = bHasCamera
+				? CalcBucket( FVector::DistSquared( camLoc , location ) , character->WasRecentlyRendered( 0.25f ) )
+				: CalcBucket( viewerDistSq , true );
+		}
+		if (bucket != entry.bucket)
+		{
+			ApplyAnimBucket( entry , bucket , bServer );
+		}
+		counts[FMath::Min( bucket , 2 )]++;
+
+		// 리플리케이트는 다른 플레이어들에게 보내는 것이므로 호스트 화면에 보이는지와 상관없이 거리로만 정하고싶다.
+		if (bServer)
+		{
+			const int32 netBucket = CalcBucket( viewerDistSq , true );
+			if (netBucket != entry.netBucket)
+			{
+				ApplyNetBucket( entry , netBucket );
+			}
+		}
+	}
+
+	SET_DWORD_STAT( STAT_SignificanceHigh , counts[0] );
+	SET_DWORD_STAT( STAT_SignificanceMedium , counts[1] );
+	SET_DWORD_STAT( STAT_SignificanceLow , counts[2] );
+}
+
+TStatId USignificanceSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT( USignificanceSubsystem , STATGROUP_Tickables );
+}
+
+void USignificanceSubsystem::Register( ANetTPSCDCharacter* character )
+{
+	if (nullptr == character || entries.ContainsByPredicate( [character]( const FSignificanceEntry& entry ) { return entry.character == character; } ))
+		return;
+
+	FSignificanceEntry& entry = entries.AddDefaulted_GetRef();
+	entry.character = character;
+	entry.baseNetUpdateFrequency = character->NetUpdateFrequency;
+	entry.baseNetPriority = character->NetPriority;
+}
+
+void USignificanceSubsystem::Unregister( ANetTPSCDCharacter* character )
+{
+	entries.RemoveAllSwap( [character]( const FSignificanceEntry& entry ) { return entry.character == character; } );
+}
+
+int32 USignificanceSubsystem::CalcBucket( double distSq , bool bVisible ) const
+{
+	for (int32 i = 0; i < buckets.Num(); i++)
+	{
+		const FSignificanceBucket& bucket = buckets[i];
+		if (distSq <= FMath::Square( bucket.maxDistance ) && (bVisible || bucket.bAllowHidden))
+			return i;
+	}
+	return buckets.Num() - 1;
+}
+
+double USignificanceSubsystem::CalcViewerDistSq( const ANetTPSCDCharacter* character ) const
+{
+	// 서버는 이 캐릭터를 보는 플레이어들 중 가장 가까운 거리로 판단하고싶다.
+	const FVector location = character->GetActorLocation();
+	double distSq = TNumericLimits<double>::Max();
+	for (auto it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		const APawn* viewer = it->IsValid() ? (*it)->GetPawn() : nullptr;
+		if (viewer && viewer != character)
+		{
+			distSq = FMath::Min( distSq , FVector::DistSquared( viewer->GetActorLocation() , location ) );
+		}
+	}
+	return distSq;
+}
+
+void USignificanceSubsystem::ApplyAnimBucket( FSignificanceEntry& entry , int32 bucket , bool bServer )
+{
+	entry.bucket = bucket;
+	ANetTPSCDCharacter* character = entry.character.Get();
+	const FSignificanceBucket& settings = buckets[bucket];
+
+	// 애니메이션 Tick 간격 (캐릭터 자체는 Tick하지 않는다)
+	USkeletalMeshComponent* mesh = character->GetMesh();
+	mesh->SetComponentTickInterval( settings.tickInterval );
+	// 가장 낮은 단계는 안 보이면 포즈도 계산하지 않는다.
+	// 서버는 재장전 노티파이를 받아야 하므로 항상 포즈를 계산한다.
+	if (false == bServer)
+	{
+		mesh->VisibilityBasedAnimTickOption = bucket == buckets.Num() - 1
+			? EVisibilityBasedAnimTickOption::OnlyTickPoseWhenRendered
+			: EVisibilityBasedAnimTickOption::AlwaysTickPoseAndRefreshBones;
+	}
+}
+
+void USignificanceSubsystem::ApplyNetBucket( FSignificanceEntry& entry , int32 bucket )
+{
+	entry.netBucket = bucket;
+	ANetTPSCDCharacter* character = entry.character.Get();
+	const FSignificanceBucket& settings = buckets[bucket];
+
+	// 서버는 리플리케이트 빈도와 우선순위를 조절하고싶다.
+	character->NetUpdateFrequency = FMath::Max( entry.baseNetUpdateFrequency * settings.netUpdateScale , character->MinNetUpdateFrequency );
+	character->NetPriority = entry.baseNetPriority * settings.netPriorityScale;
+}
@@ -0,0 +1,121 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TextFilter.h"
+
+void FTextFilter::Build( const TArray<FString>& words )
+{
+	nodes.Reset();
+	nodes.AddDefaulted();
+
+	// 1. 금지어들로 트라이를 만든다.
+	for (const FString& word : words)
+	{
+		if (word.IsEmpty())
+			continue;
+
+		int32 state = 0;
+		for (TCHAR c : word)
+		{
+			const TCHAR key = Normalize( c );
+			const int32* child = nodes[state].next.Find( key );
+			if (child)
+			{
+				state = *child;
+			}
+			else
+			{
+				const int32 newState = nodes.AddDefaulted();
+				nodes[state].next.Add( key , newState );
+				state = newState;
+			}
+		}
+		nodes[state].matchLength = FMath::Max( nodes[state].matchLength , word.Len() );
+	}
+
+	// 2. 너비 우선으로 실패 링크를 만들고, 실패 링크 쪽에서 끝나는 금지어도 물려받는다.
+	TArray<int32> queue;
+	for (const auto& it : nodes[0].next)
+	{
+		queue.Add( it.Value );
+	}
+	for (int32 i = 0; i < queue.Num(); i++)
+	{
+		const int32 state = queue[i];
+		for (const auto& it : nodes[state].next)
+		{
+			const int32 child = it.Value;
+			int32 fail = nodes[state].fail;
+			while (fail != 0 && false == nodes[fail].next.Contains( it.Key ))
+			{
+				fail = nodes[fail].fail;
+			}
+			const int32* failChild = nodes[fail].next.Find( it.Key );
+			nodes[child].fail = failChild && *failChild != child ? *failChild : 0;
+			nodes[child].matchLength = FMath::Max( nodes[child].matchLength , nodes[nodes[child].fail].matchLength );
+			queue.Add( child );
+		}
+	}
+}
+
+int32 FTextFilter::Step( int32 state , TCHAR c ) const
+{
+	const TCHAR key = Normalize( c );
+	while (true)
+	{
+		if (const int32* child = nodes[state].next.Find( key ))
+			return *child;
+		if (state == 0)
+			return 0;
+		state = nodes[state].fail;
+	}
+}
+
+bool FTextFilter::Contains( const FString& text ) const
+{
+	if (IsEmpty())
+		return false;
+
+	int32 state = 0;
+	for (TCHAR c : text)
+	{
+		state = Step( state , c );
+		if (nodes[state].matchLength > 0)
+			return true;
+	}
+	return false;
+}
+
+bool FTextFilter::Mask( FString& text ) const
+{
+	if (IsEmpty())
+		return false;
+
+	// 각 위치에서 끝나는 가장 긴 금지어의 길이를 기억해두고
+	const int32 len = text.Len();
+	TArray<int32, TInlineAllocator<128>> matchEnd;
+	matchEnd.SetNumZeroed( len );
+
+	bool bFound = false;
+	int32 state = 0;
+	for (int32 i = 0; i < len; i++)
+	{
+		state = Step( state , text[i] );
+		matchEnd[i] = nodes[state].matchLength;
+		bFound |= matchEnd[i] > 0;
+	}
+	if (false == bFound)
+		return false;
+
+	// 뒤에서부터 한번 더 훑으면서 금지어가 덮는 글자들을 가린다.
+	int32 remaining = 0;
+	for (int32 i = len - 1; i >= 0; i--)
+	{
+		remaining = FMath::Max( remaining - 1 , matchEnd[i] );
+		if (remaining > 0)
+		{
+			text[i] = TEXT( '*' );
+		}
+	}
+	return true;
+}
@@ -0,0 +1,20 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "TextFilterSubsystem.h"
+
+#include "Engine/GameInstance.h"
+
+void UTextFilterSubsystem::Initialize( FSubsystemCollectionBase& Collection )
+{
+	Super::Initialize( Collection );
+
+	filter.Build( badWords );
+}
+
+UTextFilterSubsystem* UTextFilterSubsystem::Get( const UObject* worldContext )
+{
+	const UWorld* world = worldContext ? worldContext->GetWorld() : nullptr;
+	const UGameInstance* gi = world ? world->GetGameInstance() : nullptr;
+	return gi ? gi->GetSubsystem<UTextFilterSubsystem>() : nullptr;
+}
@@ -0,0 +1,168 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "VFXPoolSubsystem.h"
+
+#include "NetTPSCD.h"
+#include "Camera/PlayerCameraManager.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/WorldSettings.h"
+#include "Particles/ParticleSystem.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_DWORD_COUNTER_STAT( TEXT( "VFX Pool Hits" ) , STAT_VFXPoolHits , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "VFX Pool Misses" ) , STAT_VFXPoolMisses , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "VFX Pool Evictions" ) , STAT_VFXPoolEvictions , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "VFX Pool Culled" ) , STAT_VFXPoolCulled , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "VFX Pool Size" ) , STAT_VFXPoolSize , STATGROUP_NetTPSCD );
+
+void UVFXPoolSubsystem::OnWorldBeginPlay( UWorld& InWorld )
+{
+	Super::OnWorldBeginPlay( InWorld );
+
+	// 화면이 없는 데디케이티드 서버는 VFX를 만들지 않는다.
+	if (InWorld.GetNetMode() == NM_DedicatedServer)
+		return;
+
+	const int32 count = FMath::Min( preallocateCount , maxPoolSize );
+	pool.Reserve( maxPoolSize );
+	activationIds.Reserve( maxPoolSize );
+	for (int32 i = 0; i < count; i++)
+	{
+		CreatePooledComponent();
+	}
+}
+
+void UVFXPoolSubsystem::Deinitialize()
+{
+	for (UParticleSystemComponent* comp : pool)
+	{
+		if (IsValid( comp ))
+		{
+			comp->DestroyComponent();
+		}
+	}
+	pool.Reset();
+	activationIds.Reset();
+	SET_DWORD_STAT( STAT_VFXPoolSize , 0 );
+
+	Super::Deinitialize();
+}
+
+UParticleSystemComponent* UVFXPoolSubsystem::SpawnAtLocation( UParticleSystem* vfx , const FVector& location , const FRotator& rotation , FPooledVFXHandle* outHandle )
+{
+	if (nullptr == vfx || GetWorld()->GetNetMode() == NM_DedicatedServer)
+		return nullptr;
+
+	if (IsCulled( location ))
+	{
+		INC_DWORD_STAT( STAT_VFXPoolCulled );
+		return nullptr;
+	}
+
+	UParticleSystemComponent* comp = nullptr;
+	int32 index = INDEX_NONE;
+	const int32 freeIndex = FindFreeIndex();
+	if (freeIndex != INDEX_NONE)
+	{
+		// 끝난 컴포넌트를 재사용
+		INC_DWORD_STAT( STAT_VFXPoolHits );
+		comp = pool[freeIndex];
+		index = freeIndex;
+		cursor = (freeIndex + 1) % pool.Num();
+	}
+	else if (pool.Num() < maxPoolSize)
+	{
+		// 아직 여유가 있으면 하나 더 만든다.
+		INC_DWORD_STAT( STAT_VFXPoolMisses );
+		comp = CreatePooledComponent();
+		index = pool.Num() - 1;
+	}
+	else if (pool.Num() > 0)
+	{
+		// 가득 찼다면 가장 오래된 것을 끊고 뺏어쓴다.
+		INC_DWORD_STAT( STAT_VFXPoolEvictions );
+		comp = pool[cursor];
+		index = cursor;
+		comp->DeactivateImmediate();
+		cursor = (cursor + 1) % pool.Num();
+	}
+
+	if (nullptr == comp)
+		return nullptr;
+
+	if (comp->Template != vfx)
+	{
+		comp->SetTemplate( vfx );
+	}
+	comp->SetWorldLocationAndRotation( location , rotation );
+	comp->ActivateSystem( true );
+
+	// 꺼낼 때마다 번호를 바꿔서 예전 핸들로는 이 재생을 끄지 못하게 하고싶다.
+	activationIds[index] = ++nextActivationId;
+	if (outHandle)
+	{
+		outHandle->comp = comp;
+		outHandle->poolIndex = index;
+		outHandle->activationId = activationIds[index];
+	}
+	return comp;
+}
+
+void UVFXPoolSubsystem::Release( const FPooledVFXHandle& handle )
+{
+	UParticleSystemComponent* comp = handle.comp.Get();
+	if (nullptr == comp)
+		return;
+
+	// 풀 밖의 컴포넌트는 끝나면 파괴되므로 살아있다면 그 재생이다.
+	if (INDEX_NONE == handle.poolIndex)
+	{
+		comp->DeactivateImmediate();
+		return;
+	}
+
+	if (pool.IsValidIndex( handle.poolIndex ) && pool[handle.poolIndex] == comp && activationIds[handle.poolIndex] == handle.activationId)
+	{
+		comp->DeactivateImmediate();
+	}
+}
+
+UParticleSystemComponent* UVFXPoolSubsystem::CreatePooledComponent()
+{
+	// SpawnEmitterAtLocation처럼 월드 세팅을 Outer로 쓰되 끝나도 파괴하지 않게 하고싶다.
+	auto comp = NewObject<UParticleSystemComponent>( GetWorld()->GetWorldSettings() );
+	comp->bAutoDestroy = false;
+	comp->bAutoActivate = false;
+	comp->SetAbsolute( true , true , true );
+	comp->RegisterComponentWithWorld( GetWorld() );
+
+	pool.Add( comp );
+	activationIds.Add( 0 );
+	SET_DWORD_STAT( STAT_VFXPoolSize , pool.Num() );
+	return comp;
+}
+
+int32 UVFXPoolSubsystem::FindFreeIndex() const
+{
+	// cursor부터 한바퀴 돌면서 오래된 순으로 찾고싶다.
+	const int32 num = pool.Num();
+	for (int32 i = 0; i < num; i++)
+	{
+		const int32 index = (cursor + i) % num;
+		if (false == pool[index]->IsActive())
+		{
+			return index;
+		}
+	}
+	return INDEX_NONE;
+}
+
+bool UVFXPoolSubsystem::IsCulled( const FVector& location ) const
+{
+	auto pc = GetWorld()->GetFirstPlayerController();
+	if (nullptr == pc || nullptr == pc->PlayerCameraManager)
+		return false;
+
+	return FVector::DistSquared( pc->PlayerCameraManager->GetCameraLocation() , location ) > FMath::Square( cullDistance );
+}
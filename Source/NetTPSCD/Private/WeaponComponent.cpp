@@ -0,0 +1,628 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponComponent.h"
+
+#include "LagCompensationSubsystem.h"
+#include "MainUI.h"
+#include "NetPlayerAnimInstance.h"
+#include "NetPlayerController.h"
+#include "NetPlayerState.h"
+#include "NetTPSCD.h"
+#include "NetTPSCDCharacter.h"
+#include "PickupSubsystem.h"
+#include "VFXPoolSubsystem.h"
+#include "Camera/CameraComponent.h"
+#include "GameFramework/GameStateBase.h"
+#include "Kismet/GameplayStatics.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Particles/ParticleSystemComponent.h"
+
+DECLARE_CYCLE_STAT( TEXT( "Send Fire Cosmetic" ) , STAT_SendFireCosmetic , STATGROUP_NetTPSCD );
+DECLARE_DWORD_ACCUMULATOR_STAT( TEXT( "FireEvent Bytes Per Event" ) , STAT_FireEventBytes , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "FireEvent Bytes Sent" ) , STAT_FireEventBytesSent , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Fire Cosmetics Sent" ) , STAT_FireCosmeticSent , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Fire Cosmetics Culled" ) , STAT_FireCosmeticCulled , STATGROUP_NetTPSCD );
+DECLARE_DWORD_COUNTER_STAT( TEXT( "Fire Cosmetics Dropped" ) , STAT_FireCosmeticDropped , STATGROUP_NetTPSCD );
+
+bool FWeaponState::NetSerialize( FArchive& Ar , UPackageMap* Map , bool& bOutSuccess )
+{
+	// 무기 4비트 + 총알 6비트 + 플래그 2비트 + 예측 번호 8비트
+	Ar.SerializeBits( &weaponId , WeaponIdBits );
+	Ar.SerializeBits( &ammo , AmmoBits );
+
+	uint8 flags = (bEquipped ? 1 : 0) | (bReloading ? 2 : 0);
+	Ar.SerializeBits( &flags , 2 );
+	bEquipped = (flags & 1) != 0;
+	bReloading = (flags & 2) != 0;
+
+	Ar << ackFireSeq;
+
+	bOutSuccess = true;
+	return true;
+}
+
+UWeaponComponent::UWeaponComponent()
+{
+	PrimaryComponentTick.bCanEverTick = false;
+
+	SetIsReplicatedByDefault( true );
+}
+
+void UWeaponComponent::OnRegister()
+{
+	Super::OnRegister();
+
+	// RPC가 BeginPlay보다 먼저 올 수 있으므로 여기서 캐릭터를 기억하고싶다.
+	player = Cast<ANetTPSCDCharacter>( GetOwner() );
+}
+
+void UWeaponComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// 태어날 때 탄창을 가득 채우고싶다.
+	bulletCount = GetMaxBulletCount();
+	if (GetOwner()->HasAuthority())
+	{
+		state.ammo = bulletCount;
+		MarkStateDirty();
+
+		spreadSalt = FMath::Rand();
+		MARK_PROPERTY_DIRTY_FROM_NAME( UWeaponComponent , spreadSalt , this );
+	}
+}
+
+const FWeaponDefinition& UWeaponComponent::GetDefinition() const
+{
+	return GetDefinition( state.weaponId );
+}
+
+const FWeaponDefinition& UWeaponComponent::GetDefinition( int32 weaponId ) const
+{
+	if (weaponId != FWeaponState::DefaultWeaponId && weaponId < UWeaponTable::MaxWeapons && weaponTable && weaponTable->weapons.IsValidIndex( weaponId ))
+	{
+		return weaponTable->weapons[weaponId];
+	}
+	return defaultWeapon;
+}
+
+int32 UWeaponComponent::GetMaxBulletCount() const
+{
+	return FMath::Clamp( GetDefinition().magazineSize , 1 , FFireEvent::MaxBulletCount );
+}
+
+void UWeaponComponent::OnRep_WeaponState( const FWeaponState& oldState )
+{
+	// 재장전을 시작했다면 재장전 애니메이션을 재생하고싶다.
+	if (state.bReloading && false == oldState.bReloading)
+	{
+		auto anim = Cast<UNetPlayerAnimInstance>( player->GetMesh()->GetAnimInstance() );
+		anim->PlayReloadAnimation();
+	}
+	// 재장전이 끝났다면 서버가 탄창을 채웠으므로 예측했던 총알들은 의미가 없다.
+	if (false == state.bReloading && oldState.bReloading)
+	{
+		predictedShots.Reset();
+	}
+
+	// 서버가 내 총알을 처리했다면 그 번호까지의 예측을 정리하고싶다.
+	if (state.ackFireSeq != oldState.ackFireSeq && player->IsLocallyControlled() && false == GetOwner()->HasAuthority())
+	{
+		ReconcileFire( state.ackFireSeq , state.ammo , false );
+		return;
+	}
+
+	// 주인은 예측중인 총알이 없을 때만 서버값으로 맞추고싶다.
+	if (player->IsLocallyControlled() && predictedShots.Num() > 0)
+		return;
+
+	if (bulletCount != state.ammo)
+	{
+		// 한발 쏜 것이라면 총알UI 하나만 지우고싶다.
+		const bool bOneShot = bulletCount - 1 == state.ammo;
+		bulletCount = state.ammo;
+		if (player->mainUI)
+		{
+			if (bOneShot)
+				player->mainUI->RemoveBulletUI( bulletCount );
+			else
+				player->mainUI->ReloadBulletUI( bulletCount );
+		}
+	}
+}
+
+void UWeaponComponent::OnRep_GrabWeapon( AActor* oldWeapon )
+{
+	if (oldWeapon == grabWeapon)
+		return;
+
+	if (oldWeapon)
+	{
+		DetachWeapon( oldWeapon );
+	}
+	if (grabWeapon)
+	{
+		AttachWeapon( grabWeapon );
+	}
+}
+
+void UWeaponComponent::MarkStateDirty()
+{
+	MARK_PROPERTY_DIRTY_FROM_NAME( UWeaponComponent , state , this );
+}
+
+void UWeaponComponent::PickupWeapon()
+{
+	if (state.bEquipped || state.bReloading)
+		return;
+
+	// 주인 없는 총들만 격자로 기억하고 있는 서브시스템에게 가장 가까운 총을 물어보고싶다.
+	AActor* _tempGrabWeapon = nullptr;
+	if (auto pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+	{
+		_tempGrabWeapon = pickups->FindNearestPickup( player->GetActorLocation() , findWeaponRadius );
+	}
+
+	// 만약 _tempGrabWeapon이 nullptr이 아니라면
+	// 서버에게 손에 붙여달라고 요청하고싶다.
+	if (_tempGrabWeapon)
+	{
+		ServerAttachWeapon( _tempGrabWeapon );
+	}
+}
+
+void UWeaponComponent::DropWeapon()
+{
+	if (false == state.bEquipped || state.bReloading)
+		return;
+
+	ServerDetachWeapon( grabWeapon );
+}
+
+void UWeaponComponent::ServerAttachWeapon_Implementation( AActor* weapon )
+{
+	// 이미 누가 잡은 총이거나 너무 먼 총은 줍지 않는다.
+	if (nullptr == weapon || weapon->GetOwner() || state.bEquipped || state.bReloading)
+		return;
+	// 붙였다 떼고 물리로 떨어지는 것은 메시뿐이라 액터 위치는 처음 자리에 그대로 있다.
+	// 클라이언트가 찾을 때(UPickupSubsystem)와 같은 메시 위치로 거리를 재고싶다.
+	const auto mesh = weapon->GetComponentByClass<UStaticMeshComponent>();
+	const FVector weaponLoc = mesh ? mesh->GetComponentLocation() : weapon->GetActorLocation();
+	if (FVector::Dist( weaponLoc , player->GetActorLocation() ) > findWeaponRadius * 2)
+		return;
+
+	SetGrabWeapon( weapon );
+}
+
+bool UWeaponComponent::ServerDetachWeapon_Validate( AActor* weapon )
+{
+	return true;
+}
+
+void UWeaponComponent::ServerDetachWeapon_Implementation( AActor* weapon )
+{
+	if (weapon != grabWeapon)
+		return;
+
+	SetGrabWeapon( nullptr );
+}
+
+void UWeaponComponent::SetGrabWeapon( AActor* weapon )
+{
+	AActor* oldWeapon = grabWeapon;
+	if (oldWeapon == weapon)
+		return;
+	const FWeaponState oldState = state;
+
+	grabWeapon = weapon;
+	MARK_PROPERTY_DIRTY_FROM_NAME( UWeaponComponent , grabWeapon , this );
+
+	if (oldWeapon)
+	{
+		oldWeapon->SetOwner( nullptr );
+	}
+	if (weapon)
+	{
+		weapon->SetOwner( player );
+
+		// 테이블에서 주운 총의 종류를 찾고싶다.
+		// 테이블에 없는 총은 기본 무기로 취급한다.
+		const int32 weaponId = weaponTable ? weaponTable->FindWeaponId( weapon->GetClass() ) : INDEX_NONE;
+		state.weaponId = INDEX_NONE == weaponId ? FWeaponState::DefaultWeaponId : static_cast<uint8>(weaponId);
+		// 탄창이 더 작은 무기라면 넘치는 총알은 버린다.
+		state.ammo = static_cast<uint8>(FMath::Min<int32>( state.ammo , GetMaxBulletCount() ));
+	}
+	else
+	{
+		// 빈손일 때도 기본 무기로 둔다.
+		state.weaponId = FWeaponState::DefaultWeaponId;
+	}
+	state.bEquipped = nullptr != weapon;
+	state.bReloading = false;
+	MarkStateDirty();
+
+	// 서버는 OnRep이 불리지 않으므로 직접 반영하고싶다.
+	OnRep_GrabWeapon( oldWeapon );
+	OnRep_WeaponState( oldState );
+}
+
+void UWeaponComponent::AttachWeapon( AActor* weapon )
+{
+	// weapon의 staticmeshcomponent를 가져오고싶다.
+	auto mesh = weapon->GetComponentByClass<UStaticMeshComponent>();
+	// weapon 물리를 끄고싶다.
+	mesh->SetSimulatePhysics( false );
+	// hand에 붙이고싶다.
+	mesh->AttachToComponent( player->handComp , FAttachmentTransformRules::SnapToTargetNotIncludingScale );
+
+	// 이제 주인이 생겼으므로 바닥의 총 목록에서 빼고싶다.
+	if (auto pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+	{
+		pickups->RemovePickup( weapon );
+	}
+
+	if (player->mainUI)
+	{
+		player->mainUI->SetActiveCrosshair( true );
+	}
+}
+
+void UWeaponComponent::DetachWeapon( AActor* weapon )
+{
+	// weapon의 staticmeshcomponent를 가져오고싶다.
+	auto mesh = weapon->GetComponentByClass<UStaticMeshComponent>();
+	// weapon 물리를 켜고싶다.
+	mesh->SetSimulatePhysics( true );
+	// hand에서 떼고싶다.
+	mesh->DetachFromComponent( FDetachmentTransformRules::KeepRelativeTransform );
+
+	// 다시 주울 수 있도록 바닥의 총 목록에 넣고싶다.
+	if (auto pickups = GetWorld()->GetSubsystem<UPickupSubsystem>())
+	{
+		pickups->AddPickup( weapon );
+	}
+
+	if (player->mainUI)
+	{
+		player->mainUI->SetActiveCrosshair( false );
+	}
+}
+
+void UWeaponComponent::Fire()
+{
+	// 내가 총을 가지고 있지 않다면 바로 함수 종료
+	// bulletCount가 0 이하라면 바로 함수 종료
+	if (false == state.bEquipped || nullptr == grabWeapon || bulletCount <= 0)
+		return;
+
+	// 만약 재장전 중이라면 함수를 바로 종료
+	if (state.bReloading)
+		return;
+
+	// 발사 간격보다 빨리 쏠 수는 없다.
+	const double now = GetWorld()->GetTimeSeconds();
+	const float fireRate = GetDefinition().fireRate;
+	if (fireRate <= 0 || now - lastFireTime < 1.0 / fireRate)
+		return;
+	lastFireTime = now;
+
+	// 서버가 아니라면 응답을 기다리지 않고 먼저 보여주고싶다.
+	uint8 fireSeq = 0;
+	if (false == GetOwner()->HasAuthority())
+	{
+		// 0은 서버가 직접 쏜 총알이므로 건너뛴다.
+		if (0 == ++lastFireSeq)
+			++lastFireSeq;
+		fireSeq = lastFireSeq;
+		PredictFire( fireSeq );
+	}
+
+	// 내 화면에 보이던 순간을 서버가 알 수 있도록 서버시간으로 보내고싶다.
+	ServerFire( GetWorld()->GetGameState()->GetServerWorldTimeSeconds() , fireSeq );
+}
+
+void UWeaponComponent::ServerFire_Implementation( double clientFireTime , uint8 fireSeq )
+{
+	const FWeaponDefinition& def = GetDefinition();
+
+	// 클라이언트의 예측을 믿지 않고 서버 상태로 다시 검사하고싶다.
+	// 서버에 도착한 시간은 네트워크 흔들림으로 몰려서 올 수 있으므로 발사 간격은 클라이언트가 쏜 시간으로 검사한다.
+	// 되감기와 같은 범위로 잘라서 너무 오래된 시간이나 미래 시간으로 몰아쏘지는 못하게 한다.
+	auto gs = GetWorld()->GetGameState();
+	const double serverNow = gs ? gs->GetServerWorldTimeSeconds() : GetWorld()->GetTimeSeconds();
+	const double shotTime = FMath::Clamp( clientFireTime , serverNow - ULagCompensationSubsystem::MaxRewindTime , serverNow );
+	const bool bTooFast = def.fireRate <= 0 || shotTime - lastServerFireTime < 0.9 / def.fireRate;
+	if (false == state.bEquipped || nullptr == grabWeapon || state.ammo <= 0 || state.bReloading || bTooFast)
+	{
+		if (fireSeq != 0)
+		{
+			ClientRejectFire( fireSeq , state.ammo , serverShotIndex );
+		}
+		return;
+	}
+	lastServerFireTime = shotTime;
+
+	// - 카메라위치에서 카메라 앞방향으로
+	auto cam = player->GetFollowCamera();
+	FHitResult OutHit;
+	FVector Start = cam->GetComponentLocation();
+	FVector End = Start + GetFireDirection( cam->GetForwardVector() , serverShotIndex++ ) * def.range;
+	// 바라보고
+	// 클라이언트의 서버시간은 편도 지연만큼 늦고, 화면의 다른 캐릭터들도 그만큼 과거 모습이다.
+	// 그래서 clientFireTime으로 되감으면 클라이언트가 보고 쏜 자세와 같아진다.
+	bool bHit = false;
+	if (auto lagComp = GetWorld()->GetSubsystem<ULagCompensationSubsystem>())
+	{
+		bHit = lagComp->RewindLineTrace( OutHit , Start , End , clientFireTime , player );
+	}
+	else
+	{
+		FCollisionQueryParams Params;
+		Params.AddIgnoredActor( player );
+		Params.bReturnPhysicalMaterial = true;
+		bHit = GetWorld()->LineTraceSingleByChannel( OutHit , Start , End , ECollisionChannel::ECC_Visibility , Params );
+	}
+
+	// 총알 수와 처리한 예측 번호는 게임플레이 상태로 리플리케이트하고싶다.
+	const FWeaponState oldState = state;
+	state.ammo--;
+	if (fireSeq != 0)
+	{
+		state.ackFireSeq = fireSeq;
+	}
+	MarkStateDirty();
+	OnRep_WeaponState( oldState );
+
+	FFireEvent fireEvent;
+	if (bHit)
+	{
+		// 만약 부딪힌 상대방이 ANetTPSCDCharacter라면
+		// 무기의 데미지만큼 주고싶다.
+		auto otherPlayer = Cast<ANetTPSCDCharacter>( OutHit.GetActor() );
+		if (otherPlayer)
+		{
+			otherPlayer->OnMyTakeDamage( def.damage );
+			// 나의 점수를 1점 증가시키고싶다.
+			auto ps = player->GetPlayerState<ANetPlayerState>();
+			ps->AddScore( 1 );
+		}
+
+		// 폭발VFX를 벽면 방향으로 세울 때만 normal을 보내고싶다.
+		fireEvent.SetHit( OutHit , nullptr == otherPlayer );
+	}
+
+	SendFireCosmetic( fireEvent , fireSeq );
+}
+
+void UWeaponComponent::SendFireCosmetic( const FFireEvent& fireEvent , uint8 fireSeq )
+{
+	SCOPE_CYCLE_COUNTER( STAT_SendFireCosmetic );
+
+#if STATS
+	// 한번 보낼 때 몇 바이트인지 측정하고싶다.
+	const int32 fireEventBytes = fireEvent.CalcNetBytes();
+	SET_DWORD_STAT( STAT_FireEventBytes , fireEventBytes );
+#endif
+
+	const FVector shooterLocation = player->GetActorLocation();
+	const double cullDistSq = FMath::Square( cosmeticCullDistance );
+	for (auto it = GetWorld()->GetPlayerControllerIterator(); it; ++it)
+	{
+		auto pc = Cast<ANetPlayerController>( it->Get() );
+		if (nullptr == pc)
+			continue;
+
+		// 예측해서 이미 보여준 주인에게는 보내지 않는다.
+		if (fireSeq != 0 && pc == player->GetController())
+			continue;
+
+		// 이 연결에서 총 쏜 캐릭터가 보이지 않거나 너무 멀면 보내지 않는다.
+		FVector viewLocation;
+		FRotator viewRotation;
+		pc->GetPlayerViewPoint( viewLocation , viewRotation );
+		const FVector effectLocation = fireEvent.bHit ? FVector( fireEvent.impactPoint ) : shooterLocation;
+		if (FVector::DistSquared( viewLocation , shooterLocation ) > cullDistSq && FVector::DistSquared( viewLocation , effectLocation ) > cullDistSq)
+		{
+			INC_DWORD_STAT( STAT_FireCosmeticCulled );
+			continue;
+		}
+		if (false == pc->IsLocalController() && false == player->IsNetRelevantFor( pc , pc->GetViewTarget() , viewLocation ))
+		{
+			INC_DWORD_STAT( STAT_FireCosmeticCulled );
+			continue;
+		}
+
+		// 연결마다 초당 보낼 수 있는 연출 수를 넘으면 버린다.
+		if (false == pc->ConsumeCosmeticToken())
+		{
+			INC_DWORD_STAT( STAT_FireCosmeticDropped );
+			continue;
+		}
+
+		pc->ClientFireCosmetic( player , fireEvent );
+		INC_DWORD_STAT( STAT_FireCosmeticSent );
+#if STATS
+		if (false == pc->IsLocalController())
+		{
+			INC_DWORD_STAT_BY( STAT_FireEventBytesSent , fireEventBytes );
+		}
+#endif
+	}
+}
+
+void UWeaponComponent::PlayFireCosmetic( const FFireEvent& fireEvent )
+{
+	// UNetPlayerAnimInstance::PlayerFireAnimation를 호출하고싶다.
+	auto anim = Cast<UNetPlayerAnimInstance>( player->GetMesh()->GetAnimInstance() );
+	anim->PlayFireAnimation();
+
+	// 만약 부딪힌곳이 있다면
+	if (fireEvent.bHit)
+	{
+		// 그곳에 폭발VFX를 배치하고싶다. (풀에서 꺼내쓴다)
+		const FRotator rot = fireEvent.bHasNormal ? fireEvent.impactNormal.Rotation() : FRotator::ZeroRotator;
+		SpawnImpactVFX( fireEvent.impactPoint , rot );
+	}
+}
+
+UParticleSystemComponent* UWeaponComponent::SpawnImpactVFX( const FVector& location , const FRotator& rotation , FPooledVFXHandle* outHandle )
+{
+	if (auto vfxPool = GetWorld()->GetSubsystem<UVFXPoolSubsystem>())
+	{
+		return vfxPool->SpawnAtLocation( GetDefinition().impactVFX , location , rotation , outHandle );
+	}
+
+	auto comp = UGameplayStatics::SpawnEmitterAtLocation( GetWorld() , GetDefinition().impactVFX , location , rotation );
+	if (outHandle)
+	{
+		outHandle->comp = comp;
+	}
+	return comp;
+}
+
+void UWeaponComponent::ReleaseImpactVFX( const FPooledVFXHandle& handle )
+{
+	if (auto vfxPool = GetWorld()->GetSubsystem<UVFXPoolSubsystem>())
+	{
+		vfxPool->Release( handle );
+	}
+	else if (handle.comp.IsValid())
+	{
+		handle.comp->DeactivateImmediate();
+	}
+}
+
+void UWeaponComponent::ClientRejectFire_Implementation( uint8 fireSeq , int32 serverBulletCount , int32 nextShotIndex )
+{
+	// 무효가 된 총알은 서버에서 순번을 쓰지 않았으므로 다음 예측은 서버 순번부터 한다.
+	predictedShotIndex = nextShotIndex;
+	ReconcileFire( fireSeq , serverBulletCount , true );
+}
+
+FVector UWeaponComponent::GetFireDirection( const FVector& forward , int32 shotIndex ) const
+{
+	const float spread = GetDefinition().spread;
+	if (spread <= 0)
+		return forward;
+
+	FRandomStream stream( static_cast<int32>(HashCombine( GetTypeHash( spreadSalt ) , GetTypeHash( shotIndex ) )) );
+	return stream.VRandCone( forward , FMath::DegreesToRadians( spread ) );
+}
+
+void UWeaponComponent::PredictFire( uint8 fireSeq )
+{
+	// 총알을 미리 차감하고 UI를 갱신하고싶다.
+	bulletCount--;
+	if (player->mainUI)
+	{
+		player->mainUI->RemoveBulletUI( bulletCount );
+	}
+
+	// 총쏘기 애니메이션을 미리 재생하고싶다.
+	auto anim = Cast<UNetPlayerAnimInstance>( player->GetMesh()->GetAnimInstance() );
+	anim->PlayFireAnimation();
+
+	// 내 화면 기준으로 쏴보고 부딪힌 곳에 임시 VFX를 보여주고싶다.
+	FPredictedShot shot;
+	shot.fireSeq = fireSeq;
+
+	const FWeaponDefinition& def = GetDefinition();
+	auto cam = player->GetFollowCamera();
+	FHitResult OutHit;
+	FVector Start = cam->GetComponentLocation();
+	FVector End = Start + GetFireDirection( cam->GetForwardVector() , predictedShotIndex++ ) * def.range;
+	FCollisionQueryParams Params;
+	Params.AddIgnoredActor( player );
+	if (GetWorld()->LineTraceSingleByChannel( OutHit , Start , End , ECollisionChannel::ECC_Visibility , Params ))
+	{
+		SpawnImpactVFX( OutHit.ImpactPoint , OutHit.ImpactNormal.Rotation() , &shot.vfx );
+	}
+
+	predictedShots.Add( shot );
+}
+
+void UWeaponComponent::ReconcileFire( uint8 fireSeq , int32 serverBulletCount , bool bRejected )
+{
+	// 응답은 쏜 순서대로 오므로 fireSeq와 그 이전 예측들은 이제 끝났다.
+	// 번호가 한바퀴 돌 수 있으므로 부호있는 차이로 비교한다.
+	while (predictedShots.Num() > 0 && static_cast<int8>(predictedShots[0].fireSeq - fireSeq) <= 0)
+	{
+		// 무효가 된 총알의 임시 VFX는 지우고싶다.
+		if (bRejected && predictedShots[0].fireSeq == fireSeq)
+		{
+			ReleaseImpactVFX( predictedShots[0].vfx );
+		}
+		predictedShots.RemoveAt( 0 , 1 , false );
+	}
+
+	// 서버 총알 수에서 아직 응답이 안 온 예측분을 빼면 내 화면의 총알 수가 된다.
+	const int32 newBulletCount = FMath::Max( serverBulletCount - predictedShots.Num() , 0 );
+	if (newBulletCount != bulletCount)
+	{
+		bulletCount = newBulletCount;
+		if (player->mainUI)
+		{
+			player->mainUI->ReloadBulletUI( bulletCount );
+		}
+	}
+}
+
+void UWeaponComponent::Reload()
+{
+	// 만약 재장전 중이라면 함수를 바로 종료
+	if (state.bReloading)
+		return;
+
+	ServerReload();
+}
+
+void UWeaponComponent::ServerReload_Implementation()
+{
+	if (false == state.bEquipped || state.bReloading)
+		return;
+
+	// 재장전 상태만 바꾸면 클라이언트들은 OnRep에서 애니메이션을 재생한다.
+	const FWeaponState oldState = state;
+	state.bReloading = true;
+	MarkStateDirty();
+
+	OnRep_WeaponState( oldState );
+}
+
+void UWeaponComponent::ServerInitAmmo_Implementation()
+{
+	// 재장전 애니메이션이 끝났을 때만 채워준다.
+	if (false == state.bReloading)
+		return;
+
+	InitAmmo();
+}
+
+void UWeaponComponent::InitAmmo()
+{
+	const FWeaponState oldState = state;
+	state.ammo = static_cast<uint8>(GetMaxBulletCount());
+	state.bReloading = false;
+	MarkStateDirty();
+
+	OnRep_WeaponState( oldState );
+}
+
+void UWeaponComponent::GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const
+{
+	Super::GetLifetimeReplicatedProps( OutLifetimeProps );
+
+	// 바뀔 때만 MarkStateDirty로 알려주므로 매 프레임 비교하지 않는다.
+	FDoRepLifetimeParams params;
+	params.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST( UWeaponComponent , state , params );
+	DOREPLIFETIME_WITH_PARAMS_FAST( UWeaponComponent , grabWeapon , params );
+
+	// 탄퍼짐 씨앗은 예측하는 주인에게만 필요하다.
+	FDoRepLifetimeParams ownerParams;
+	ownerParams.bIsPushBased = true;
+	ownerParams.Condition = COND_OwnerOnly;
+	DOREPLIFETIME_WITH_PARAMS_FAST( UWeaponComponent , spreadSalt , ownerParams );
+}
@@ -0,0 +1,21 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "WeaponTable.h"
+
+int32 UWeaponTable::FindWeaponId( const UClass* pickupClass ) const
+{
+	if (nullptr == pickupClass)
+		return INDEX_NONE;
+
+	const int32 num = FMath::Min( weapons.Num() , MaxWeapons );
+	for (int32 i = 0; i < num; i++)
+	{
+		const UClass* weaponClass = weapons[i].pickupClass.Get();
+		if (weaponClass && pickupClass->IsChildOf( weaponClass ))
+		{
+			return i;
+		}
+	}
+	return INDEX_NONE;
+}
@@ -1,4 +1,4 @@
-// Fill out your copyright notice in the Description page of Project Settings.
+﻿// Fill out your copyright notice in the Description page of Project Settings.
 
 #pragma once
 
@@ -13,5 +13,18 @@ UCLASS()
 class NETTPSCD_API ABattleGameMode : public AGameModeBase
 {
 	GENERATED_BODY()
-	
+
+public:
+	ABattleGameMode();
+
+	// 리슨서버에서 컨트롤러 없는 캐릭터 count개를 만들어서 리플리케이트 비용을 재보고싶다.
+	// net.IsPushModelEnabled 0/1 로 바꿔가며 stat net 의 Server Rep Actors Time 과 stat NetTPSCD 를 비교한다.
+	UFUNCTION( Exec )
+	void SpawnRepBots( int32 count );
+
+	UFUNCTION( Exec )
+	void DestroyRepBots();
+
+	UPROPERTY()
+	TArray<class APawn*> repBots;
 };
@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "BillboardSubsystem.generated.h"
+
+/**
+ * 캐릭터마다 Tick에서 카메라를 찾아 hpUIComp를 돌리지 않고
+ * 한 프레임에 한번 카메라를 가져와서 등록된 위젯들을 한번에 카메라 쪽으로 돌리고싶다.
+ * 화면 밖이거나 너무 먼 위젯은 돌리지 않는다.
+ */
+UCLASS()
+class NETTPSCD_API UBillboardSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register( class USceneComponent* comp );
+	void Unregister( USceneComponent* comp );
+
+	// 이보다 먼 위젯은 돌리지 않는다.
+	static constexpr float MaxDistance = 5000.0f;
+	// 이보다 적게 돌아야 한다면 SetWorldRotation을 하지 않는다. (도)
+	static constexpr float MinYawDelta = 0.5f;
+
+private:
+	TArray<TWeakObjectPtr<USceneComponent>> billboards;
+};
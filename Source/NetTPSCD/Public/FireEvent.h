@@ -0,0 +1,56 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "FireEvent.generated.h"
+
+// 총쏘기 연출(애니메이션, 폭발VFX)을 클라이언트에게 보낼 때 FHitResult 대신 쓰고싶다.
+// 클라이언트가 실제로 쓰는 값만 비트 단위로 압축해서 보낸다.
+// 총알 수 같은 게임플레이 값은 UWeaponComponent::state로 따로 리플리케이트한다.
+USTRUCT()
+struct NETTPSCD_API FFireEvent
+{
+	GENERATED_BODY()
+
+	// 총알 갯수는 6비트(0~63)로 보낸다. (FWeaponState)
+	static constexpr uint32 BulletCountBits = 6;
+	static constexpr int32 MaxBulletCount = (1 << BulletCountBits) - 1;
+	// EPhysicalSurface는 64개 이하이므로 6비트면 충분하다.
+	static constexpr uint32 SurfaceBits = 6;
+
+	UPROPERTY()
+	bool bHit = false;
+
+	UPROPERTY()
+	bool bHasNormal = false;
+
+	// 부딪힌 곳 (1cm 단위로 양자화)
+	UPROPERTY()
+	FVector_NetQuantize impactPoint;
+
+	// 부딪힌 면의 방향 (bHasNormal일 때만 보낸다)
+	UPROPERTY()
+	FVector_NetQuantizeNormal impactNormal;
+
+	// 부딪힌 면의 재질 (EPhysicalSurface)
+	UPROPERTY()
+	uint8 surface = 0;
+
+	void SetHit( const FHitResult& hitInfo , bool bWithNormal );
+
+	bool NetSerialize( FArchive& Ar , class UPackageMap* Map , bool& bOutSuccess );
+
+	// 한번 보낼 때 드는 바이트 수 (stat 측정용)
+	int32 CalcNetBytes() const;
+};
+
+template<>
+struct TStructOpsTypeTraits<FFireEvent> : public TStructOpsTypeTraitsBase2<FFireEvent>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
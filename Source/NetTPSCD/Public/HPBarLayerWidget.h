@@ -0,0 +1,55 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Blueprint/UserWidget.h"
+#include "HPBarLayerWidget.generated.h"
+
+/**
+ * 캐릭터마다 UWidgetComponent(렌더타겟)로 체력바를 그리지 않고
+ * 화면 전체를 덮는 위젯 하나가 보이는 상대방들의 체력바를 한번에 그리고싶다.
+ * ANetPlayerController::bScreenSpaceHPBars가 켜져 있을 때 사용한다.
+ */
+UCLASS()
+class NETTPSCD_API UHPBarLayerWidget : public UUserWidget
+{
+	GENERATED_BODY()
+
+public:
+	virtual void NativeTick( const FGeometry& MyGeometry , float InDeltaTime ) override;
+
+	// 이보다 먼 캐릭터의 체력바는 그리지 않는다.
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	float maxDistance = 5000;
+
+	// 머리 위 얼마나 높이 그릴지
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	float heightOffset = 110;
+
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	FVector2D barSize = FVector2D( 80 , 8 );
+
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	FLinearColor backColor = FLinearColor( 0 , 0 , 0 , 0.6f );
+
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	FLinearColor fillColor = FLinearColor( 0.9f , 0.1f , 0.1f , 1 );
+
+	// 비워두면 단색으로 그린다.
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	FSlateBrush barBrush;
+
+protected:
+	virtual int32 NativePaint( const FPaintArgs& Args , const FGeometry& AllottedGeometry , const FSlateRect& MyCullingRect , FSlateWindowElementList& OutDrawElements , int32 LayerId , const FWidgetStyle& InWidgetStyle , bool bParentEnabled ) const override;
+
+private:
+	// 이번 프레임에 그릴 체력바 (위젯 좌표, 체력 비율)
+	struct FHPBarDraw
+	{
+		FVector2D position;
+		float hp;
+	};
+
+	TArray<FHPBarDraw> bars;
+};
@@ -0,0 +1,34 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/NetSerialization.h"
+#include "KinematicMotion.generated.h"
+
+// 일정하게 도는 소품의 움직임. 매 프레임 회전값을 보내지 않고 이것만 한번 보내면
+// 클라이언트가 서버 시간으로 같은 회전값을 직접 계산한다. 바뀔 때만 다시 보낸다.
+USTRUCT()
+struct NETTPSCD_API FKinematicMotion
+{
+	GENERATED_BODY()
+
+	// 움직임을 시작한 서버 시간 (AGameStateBase::GetServerWorldTimeSeconds)
+	UPROPERTY()
+	double startTime = 0;
+
+	// startTime 때의 회전
+	UPROPERTY()
+	FRotator startRotation = FRotator::ZeroRotator;
+
+	// 회전축 (월드 기준)
+	UPROPERTY()
+	FVector_NetQuantizeNormal axis = FVector::UpVector;
+
+	// 초당 회전 각도 (도)
+	UPROPERTY()
+	float angularSpeed = 0;
+
+	// serverTime 때의 회전을 계산하고싶다.
+	FQuat Evaluate( double serverTime ) const;
+};
@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "LagCompensationSubsystem.generated.h"
+
+// 한 순간의 캐릭터 캡슐 자세. 캐릭터 캡슐은 항상 서 있으므로 회전은 기억하지 않는다.
+struct FHitboxPose
+{
+	FVector location = FVector::ZeroVector;
+	float radius = 0;
+	float halfHeight = 0;
+};
+
+// 캐릭터 한명의 최근 자세를 담는 고정 크기 링버퍼
+// 미리 할당된 배열에 덮어쓰기만 하므로 매 프레임 기록해도 메모리 할당이 없다.
+struct FHitboxHistory
+{
+	// 2의 거듭제곱이어야 한다. 60fps 기준 약 1초
+	static constexpr int32 Capacity = 64;
+
+	double times[Capacity];
+	FHitboxPose poses[Capacity];
+	// 다음에 기록할 위치
+	int32 head = 0;
+	int32 num = 0;
+
+	void Reset();
+	void Record( double time , const FHitboxPose& pose );
+	// time 시점의 자세를 앞뒤 기록 사이에서 보간해서 알려준다.
+	bool Sample( double time , FHitboxPose& outPose ) const;
+};
+
+/**
+ * 서버에서 캐릭터들의 캡슐 자세를 매 프레임 기록해두고
+ * 총을 쏜 클라이언트가 보고 있던 시점으로 되감아서 판정하고싶다.
+ */
+UCLASS()
+class NETTPSCD_API ULagCompensationSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+	// 서버에서 기록할 캐릭터를 등록/해제
+	void Register( class ANetTPSCDCharacter* character );
+	void Unregister( ANetTPSCDCharacter* character );
+
+	// 캐릭터들은 time 시점의 자세로, 나머지 월드는 현재 상태로 라인트레이스를 하고싶다.
+	bool RewindLineTrace( FHitResult& outHit , const FVector& start , const FVector& end , double time , const AActor* ignoreActor ) const;
+
+	// 서버 기준 현재 시간
+	double GetServerTime() const;
+
+	// 이보다 오래된 시점으로는 되감지 않는다. (초)
+	static constexpr double MaxRewindTime = 0.4;
+
+private:
+	// 같은 인덱스끼리 짝이다.
+	TArray<TWeakObjectPtr<ANetTPSCDCharacter>> characters;
+	TArray<FHitboxHistory> histories;
+};
@@ -17,6 +17,7 @@ class NETTPSCD_API UMainUI : public UUserWidget
 public:
 
 	virtual void NativeConstruct() override;
+	virtual void NativeDestruct() override;
 
 
 	// ImageCrosshair를 BindWidget 해보세요.
@@ -34,9 +35,15 @@ public:
 	UPROPERTY( EditDefaultsOnly )
 	TSubclassOf<class UUserWidget> bulletUIFactory;
 
+	// 총알 위젯은 한번만 만들어두고 보이기/숨기기만 바꾸고싶다.
+	// 숨길 때는 Hidden으로 자리를 유지해서 총을 쏠 때 레이아웃이 다시 계산되지 않게 한다.
 	void ReloadBulletUI(int32 maxBulletCount);
 	void AddBulletUI();
 	void RemoveBulletUI(int32 index);
+	void SetBulletVisible( int32 index , bool bVisible );
+
+	UPROPERTY()
+	TArray<class UUserWidget*> bulletIcons;
 
 	UPROPERTY( EditDefaultsOnly , meta = (BindWidget) )
 	class UProgressBar* bar_hp;
@@ -75,7 +82,22 @@ public:
 	UPROPERTY( EditDefaultsOnly , meta = (BindWidget) )
 	class UTextBlock* txt_players;
 
-	virtual void NativeTick(const FGeometry& MyGeometry, float InDeltaTime) override;
+	// 점수판 ---------------------------------------------
+	// 플레이어마다 한 줄씩 기억해두고 바뀐 줄이 있을 때만 txt_players를 갱신하고싶다.
+	struct FScoreRow
+	{
+		TWeakObjectPtr<class APlayerState> ps;
+		FString text;
+	};
+	TArray<FScoreRow> scoreRows;
+
+	void OnPlayerStateChanged( class ANetPlayerState* ps );
+	void OnPlayerStateRemoved( ANetPlayerState* ps );
+	void UpdateScoreRow( APlayerState* ps );
+	void RefreshScoreboard();
+
+	FDelegateHandle playerStateChangedHandle;
+	FDelegateHandle playerStateRemovedHandle;
 
 
 	UPROPERTY( EditDefaultsOnly , meta = (BindWidget) )
@@ -97,4 +119,18 @@ public:
 
 	// 서버통신 후 응답처리할 함수
 	void RecvMsg(const FString& msg );
+
+	// 채팅창에 남겨둘 최대 메시지 수. 넘치면 가장 오래된 메시지(위젯)를 다시 쓴다.
+	static constexpr int32 MaxChatMessages = 100;
+
+	// 있으면 보이는 줄만 위젯으로 만드는 리스트뷰를 쓰고, 없으면 scroll_msg를 쓴다.
+	UPROPERTY( EditDefaultsOnly , meta = (BindWidgetOptional) )
+	class UListView* list_msg;
+
+	// list_msg의 아이템 링버퍼
+	UPROPERTY()
+	TArray<class UChatMessageItem*> chatItems;
+
+	// 다음에 다시 쓸 (가장 오래된) 아이템
+	int32 chatHead = 0;
 };
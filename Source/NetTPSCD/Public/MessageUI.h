@@ -4,17 +4,31 @@
 
 #include "CoreMinimal.h"
 #include "Blueprint/UserWidget.h"
+#include "Blueprint/IUserObjectListEntry.h"
 #include "MessageUI.generated.h"
 
+// 채팅 리스트뷰의 아이템. 채팅창이 가득 차면 가장 오래된 것을 다시 쓴다.
+UCLASS()
+class NETTPSCD_API UChatMessageItem : public UObject
+{
+	GENERATED_BODY()
+public:
+	FString msg;
+};
+
 /**
  * 
  */
 UCLASS()
-class NETTPSCD_API UMessageUI : public UUserWidget
+class NETTPSCD_API UMessageUI : public UUserWidget , public IUserObjectListEntry
 {
 	GENERATED_BODY()
 public:
 
 	UPROPERTY(EditDefaultsOnly, meta=(BindWidget))
 	class UTextBlock* txt_msg;
+
+protected:
+	// 리스트뷰가 이 위젯을 다른 메시지에 다시 쓸 때 호출된다.
+	virtual void NativeOnListItemObjectSet( UObject* ListItemObject ) override;
 };
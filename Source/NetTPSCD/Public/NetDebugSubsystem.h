@@ -0,0 +1,51 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "NetDebugSubsystem.generated.h"
+
+/**
+ * 액터마다 매 프레임 문자열을 만들어 DrawDebugString 하지 않고
+ * 등록된 액터들의 네트워크 정보(Owner, Connection, Role)를 한번에 화면에 그리고싶다.
+ * NetTPSCD.NetDebug 1 로 켜고, Shipping/Test 빌드에서는 아무것도 하지 않는다.
+ */
+UCLASS()
+class NETTPSCD_API UNetDebugSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual bool ShouldCreateSubsystem( UObject* Outer ) const override;
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+	virtual void Deinitialize() override;
+
+	void Register( AActor* actor );
+	void Unregister( AActor* actor );
+
+	// NetTPSCD.NetDebug 가 켜져 있는가? (Shipping/Test 빌드에서는 항상 false)
+	static bool IsEnabled();
+
+private:
+	// 한 액터의 마지막 네트워크 정보와 그걸로 만든 문자열
+	struct FNetDebugEntry
+	{
+		TWeakObjectPtr<AActor> actor;
+		TWeakObjectPtr<AActor> owner;
+		bool bHasConnection = false;
+		bool bLocallyControlled = false;
+		ENetRole localRole = ROLE_None;
+		ENetRole remoteRole = ROLE_None;
+		FString text;
+	};
+
+	// 정보가 바뀌었을 때만 문자열을 다시 만들고싶다.
+	void RefreshText( FNetDebugEntry& entry );
+
+	void DrawOverlay( class UCanvas* canvas , class APlayerController* pc );
+
+	TArray<FNetDebugEntry> entries;
+
+	FDelegateHandle drawHandle;
+};
@@ -33,6 +33,8 @@ struct FRoomInfo
 // 그래서 델리게이트를 만들어서 LobbyWidget에서 AddRoomInfoWidget을 델리게이트에 추가 하고싶다.
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FAddRoomInfoDelegate , const FRoomInfo& , roomInfo );
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam( FFindingRoomsDelegate , bool , bActive );
+// 방에 들어가거나 나왔을 때 알려주고싶다. 매번 IsInRoom을 물어보지 말고 여기에 등록한다.
+DECLARE_MULTICAST_DELEGATE_OneParam( FRoomMembershipDelegate , bool /*bInRoom*/ );
 
 
 UCLASS()
@@ -43,7 +45,11 @@ public:
 	// 시작할 때 세션인터페이스를 기억하고싶다.
 	virtual void Init() override;
 
-	bool IsInRoom();
+	// 세션 이벤트 때 갱신해둔 값을 돌려준다.
+	bool IsInRoom() const { return bInRoom; }
+
+	// 방에 들어가거나 나왔을 때 불린다.
+	FRoomMembershipDelegate onRoomMembershipChanged;
 
 
 	IOnlineSessionPtr sessionInterface;
@@ -86,6 +92,14 @@ public:
 	UFUNCTION()
 	void OnMyExitRoomComplete( FName sessionName , bool bWasSuccessful );
 
+	// 방 입장 여부 -----------------------------------------
+	// 세션 생성/입장/파괴/플레이어 등록 때만 세션에 내가 있는지 검사해서 기억하고싶다.
+	bool bInRoom = false;
+
+	void RefreshInRoom();
+
+	void OnMyRegisterPlayersComplete( FName sessionName , const TArray<FUniqueNetIdRef>& players , bool bWasSuccessful );
+
 	FString StringBase64Encode(const FString& str);
 	FString StringBase64Decode(const FString& str);
 };
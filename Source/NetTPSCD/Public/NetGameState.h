@@ -0,0 +1,64 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameStateBase.h"
+#include "NetGameState.generated.h"
+
+/**
+ * 서버에서 채팅을 모아서 처리하고싶다.
+ * 길이 제한, 플레이어별 횟수 제한(토큰 버킷), 금지어 가리기를 한 뒤
+ * 네트워크 틱마다 한번만 묶어서 모든 클라이언트에게 보낸다.
+ */
+UCLASS()
+class NETTPSCD_API ANetGameState : public AGameStateBase
+{
+	GENERATED_BODY()
+
+public:
+	ANetGameState();
+
+	virtual void BeginPlay() override;
+	virtual void Tick( float DeltaSeconds ) override;
+
+	// 서버에서 sender의 채팅을 받아 검사하고 다음 묶음에 넣고싶다.
+	void ServerSubmitChat( APlayerState* sender , const FString& msg );
+
+	// 서버2클라 이번 묶음의 채팅들을 채팅창에 보여줘라.
+	UFUNCTION( NetMulticast , Reliable )
+	void MultiChatBatch( const TArray<FString>& messages );
+
+	// 한 메시지의 최대 글자 수
+	UPROPERTY( EditDefaultsOnly , Category = Chat , meta = (ClampMin = "1") )
+	int32 maxChatLength = 128;
+
+	// 플레이어 한명이 초당 보낼 수 있는 메시지 수와 한번에 몰아서 보낼 수 있는 수
+	UPROPERTY( EditDefaultsOnly , Category = Chat )
+	float chatMessagesPerSecond = 2;
+
+	UPROPERTY( EditDefaultsOnly , Category = Chat )
+	float chatBurst = 5;
+
+	// 한 묶음에 넣을 최대 메시지 수. 넘치는 것은 다음 묶음으로 미룬다.
+	UPROPERTY( EditDefaultsOnly , Category = Chat , meta = (ClampMin = "1") )
+	int32 maxChatBatchSize = 32;
+
+private:
+	struct FChatBucket
+	{
+		float tokens = 0;
+		double time = 0;
+	};
+
+	// 플레이어별 채팅 토큰
+	TMap<TWeakObjectPtr<APlayerState> , FChatBucket> chatBuckets;
+
+	// 다음 묶음으로 보낼 메시지들
+	TArray<FString> pendingChat;
+
+	double lastChatFlushTime = 0;
+
+	bool ConsumeChatToken( APlayerState* sender );
+	void FlushChat();
+};
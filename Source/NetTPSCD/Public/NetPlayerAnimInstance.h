@@ -17,7 +17,22 @@ class NETTPSCD_API UNetPlayerAnimInstance : public UAnimInstance
 public:
 
 	virtual void NativeInitializeAnimation() override;
-	virtual void NativeUpdateAnimation(float DeltaSeconds) override;
+
+	// 애니메이션 값 계산을 게임스레드 밖(워커스레드)에서 하고싶다.
+	// NativeUpdateAnimation(게임스레드)에서 캐릭터 값을 한번 복사하고
+	// NativeThreadSafeUpdateAnimation(워커스레드)에서 계산한다. 둘 다 그래프 평가 전에 불리므로
+	// 애님블루프린트는 이번 프레임의 값을 읽는다.
+	virtual void NativeUpdateAnimation( float DeltaSeconds ) override;
+	virtual void NativeThreadSafeUpdateAnimation( float DeltaSeconds ) override;
+
+private:
+	// 게임스레드에서 복사해오는 값
+	bool bValid = false;
+	FVector velocity = FVector::ZeroVector;
+	FQuat actorRotation = FQuat::Identity;
+	FRotator aimRotation = FRotator::ZeroRotator;
+
+public:
 
 	UPROPERTY()
 	class ANetTPSCDCharacter* player;
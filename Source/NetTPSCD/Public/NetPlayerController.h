@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/PlayerController.h"
+#include "FireEvent.h"
+#include "ScheduledTasks.h"
 #include "NetPlayerController.generated.h"
 
 /**
@@ -17,6 +19,7 @@ class NETTPSCD_API ANetPlayerController : public APlayerController
 public:
 
 	virtual void BeginPlay() override;
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
 
 	// 태어날 때 내가 서버라면 게임모드를 기억하고싶다.
 	UPROPERTY()
@@ -30,6 +33,17 @@ public:
 	UPROPERTY()
 	class UMainUI* mainUI;
 
+	// 켜면 캐릭터마다 hpUIComp를 쓰지 않고 화면 위젯 하나가 모든 체력바를 그린다.
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	bool bScreenSpaceHPBars = false;
+
+	// 비워두면 UHPBarLayerWidget 기본값으로 만든다.
+	UPROPERTY( EditDefaultsOnly , Category = HPBar )
+	TSubclassOf<class UHPBarLayerWidget> hpBarLayerFactory;
+
+	UPROPERTY()
+	class UHPBarLayerWidget* hpBarLayer;
+
 
 	// 재시작요청이 오면 서버RPC로 서버에게 현재 플레이어를 UnPossess하고 파괴하고, 게임모드에게 재시작 하라고 하고싶다.
 	UFUNCTION(Server, Reliable)
@@ -40,5 +54,39 @@ public:
 	UFUNCTION( Server , Reliable )
 	void ServerRetrySpectator();
 
+	// 타이머 핸들은 컨트롤러가 들고 있고 EndPlay에서 모두 취소한다.
+	FScheduledTasks tasks;
+	int32 retryTask = INDEX_NONE;
+
+	// 클라2서버 채팅을 보내주세요. 폰이 죽어있거나 없어도 보낼 수 있다.
+	UFUNCTION( Server , Reliable )
+	void ServerSendChat( const FString& msg );
+
+	// 채팅창에 count개의 메시지를 넣어보고 걸린 시간과 메모리 증가량을 로그로 남기고싶다.
+	UFUNCTION( Exec )
+	void BenchChat( int32 count = 10000 );
+
+	// 금지어 검사를 예전 방식(단어마다 Contains/Replace)과 FTextFilter로 count번씩 해보고 걸린 시간을 로그로 남기고싶다.
+	UFUNCTION( Exec )
+	void BenchTextFilter( int32 count = 100000 );
+
+	// 총쏘기 연출 ------------------------------------------
+	// 서버2클라 shooter의 총쏘기 연출을 보여줘라. 잃어버려도 게임에는 영향이 없다.
+	UFUNCTION( Client , Unreliable )
+	void ClientFireCosmetic( class ANetTPSCDCharacter* shooter , const FFireEvent& fireEvent );
+
+	// 이 연결로 초당 보낼 수 있는 연출 수와 한번에 몰아서 보낼 수 있는 수
+	UPROPERTY( EditDefaultsOnly , Category = Cosmetic )
+	float cosmeticEventsPerSecond = 30;
+
+	UPROPERTY( EditDefaultsOnly , Category = Cosmetic )
+	float cosmeticBurst = 10;
+
+	// 서버에서 연출을 하나 보내도 되는지 토큰 버킷으로 검사하고싶다.
+	bool ConsumeCosmeticToken();
+
+	float cosmeticTokens = 0;
+	double cosmeticTokenTime = 0;
+
 	
 };
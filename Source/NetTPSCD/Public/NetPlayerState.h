@@ -6,6 +6,8 @@
 #include "GameFramework/PlayerState.h"
 #include "NetPlayerState.generated.h"
 
+DECLARE_MULTICAST_DELEGATE_OneParam( FOnNetPlayerStateChanged , class ANetPlayerState* );
+
 /**
  * 
  */
@@ -15,6 +17,19 @@ class NETTPSCD_API ANetPlayerState : public APlayerState
 	GENERATED_BODY()
 public:
 	virtual void BeginPlay() override;
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+	// 점수판이 매 프레임 PlayerArray를 돌지 않도록 바뀔 때만 알려주고싶다.
+	// 들어오거나 이름/점수가 바뀌면 OnPlayerStateChanged, 나가면 OnPlayerStateRemoved
+	// 모든 월드가 같이 쓰므로 받는 쪽에서 GetWorld()를 비교해야 한다.
+	static FOnNetPlayerStateChanged OnPlayerStateChanged;
+	static FOnNetPlayerStateChanged OnPlayerStateRemoved;
+
+	virtual void OnRep_Score() override;
+	virtual void OnRep_PlayerName() override;
+
+	// 서버에서 점수를 올린다. 서버는 OnRep이 불리지 않으므로 직접 알려준다.
+	void AddScore( int32 amount );
 
 	UFUNCTION(Server, Reliable)
 	void ServerSetNickname(const FString& newNickmane );
@@ -0,0 +1,69 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "NetRepPolicyComponent.generated.h"
+
+/**
+ * 월드에 놓인 소품 액터의 리플리케이트 비용을 줄이고싶다. (서버에서만 동작)
+ * - 상태가 한동안 안 바뀌거나 가끔씩만 바뀌면 휴면(Dormant)시킨다.
+ *   휴면 중에 가끔 바뀌면 그 값만 보내고(FlushNetDormancy), 자주 바뀌기 시작하면 깨운다.
+ * - 상태가 바뀌는 빈도에 맞춰 NetUpdateFrequency를 조절한다.
+ * - netCullDistance보다 먼 플레이어에게는 보내지 않는다.
+ * 주인 액터는 리플리케이트 값을 바꿀 때마다 NotifyStateChanged를 호출해야 한다.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class NETTPSCD_API UNetRepPolicyComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UNetRepPolicyComponent();
+
+protected:
+	virtual void BeginPlay() override;
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
+public:
+	virtual void TickComponent( float DeltaTime , ELevelTick TickType , FActorComponentTickFunction* ThisTickFunction ) override;
+
+	// 서버에서 주인의 리플리케이트 값이 바뀌었다. 휴면 중이면 바뀐 값을 보내고싶다.
+	void NotifyStateChanged();
+
+	bool IsDormant() const { return bDormant; }
+
+	// 이 시간(초) 동안 바뀐 것이 없으면 휴면시킨다.
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float idleTimeBeforeDormant = 2.0f;
+
+	// 바뀌는 간격이 이보다 길면(초) 휴면한 채로 바뀔 때마다 한번씩만 보낸다. 더 자주 바뀌면 깨운다.
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float flushChangeInterval = 0.5f;
+
+	// 바뀌는 빈도에 맞춰 이 범위 안에서 NetUpdateFrequency를 정한다.
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float minNetUpdateFrequency = 2.0f;
+
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float maxNetUpdateFrequency = 30.0f;
+
+	// 이보다 먼 플레이어에게는 리플리케이트하지 않는다.
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float netCullDistance = 5000.0f;
+
+	// 빈도를 다시 계산하는 간격 (초)
+	UPROPERTY( EditDefaultsOnly , Category = Net )
+	float updateInterval = 0.5f;
+
+private:
+	void SetDormant( bool bNewDormant );
+
+	bool bDormant = false;
+	double lastChangeTime = 0;
+
+	// 지난 계산 이후 바뀐 횟수와 초당 바뀌는 횟수의 평균
+	int32 changeCount = 0;
+	float changeRate = 0;
+};
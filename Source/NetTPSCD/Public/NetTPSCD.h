@@ -1,5 +1,13 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
+﻿// Copyright Epic Games, Inc. All Rights Reserved.
 
 #pragma once
 
 #include "CoreMinimal.h"
+
+// stat NetTPSCD 로 게임플레이 관련 수치를 확인하고싶다.
+DECLARE_STATS_GROUP( TEXT( "NetTPSCD" ) , STATGROUP_NetTPSCD , STATCAT_Advanced );
+
+// 네트워크 디버그 표시(UNetDebugSubsystem)는 Shipping/Test 빌드에서 빼고싶다.
+#ifndef NETTPSCD_NET_DEBUG
+#define NETTPSCD_NET_DEBUG (!(UE_BUILD_SHIPPING || UE_BUILD_TEST))
+#endif
@@ -17,6 +17,32 @@ struct FInputActionValue;
 DECLARE_LOG_CATEGORY_EXTERN(LogTemplateCharacter, Log, All);
 DECLARE_LOG_CATEGORY_EXTERN( MyLog , Log , All );
 
+// 캐릭터의 생존 상태. 죽음은 hp로 알 수 있으므로 hp만 7비트로 리플리케이트한다.
+USTRUCT()
+struct FCharacterVitals
+{
+	GENERATED_BODY()
+
+	static constexpr uint32 HPBits = 7;
+	static constexpr int32 MaxHP = (1 << HPBits) - 1;
+
+	UPROPERTY()
+	uint8 hp = 0;
+
+	bool IsDead() const { return 0 == hp; }
+
+	bool NetSerialize( FArchive& Ar , class UPackageMap* Map , bool& bOutSuccess );
+};
+
+template<>
+struct TStructOpsTypeTraits<FCharacterVitals> : public TStructOpsTypeTraitsBase2<FCharacterVitals>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
 UCLASS(config=Game)
 class ANetTPSCDCharacter : public ACharacter
 {
@@ -65,9 +91,11 @@ protected:
 	// To add mapping context
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 	virtual void PossessedBy(AController* NewController) override;
 
-	virtual void Tick(float DeltaSeconds) override;
+	virtual void PostInitializeComponents() override;
 
 	void InitUI();
 
@@ -85,9 +113,6 @@ protected:
 	void DropPistol(const FInputActionValue& Value);
 
 public:
-	UPROPERTY(Replicated)
-	bool bHasPistol = false;
-
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = Input, meta = (AllowPrivateAccess = "true"))
 	UInputAction* PickupPistolAction;
 
@@ -98,18 +123,13 @@ public:
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pistol)
 	class USceneComponent* handComp;
 
-	// 총을 잡을 수 있는 검색 거리
-	UPROPERTY(EditDefaultsOnly, Category = Pistol)
-	float findPistolRadius = 150;
+	// 총 줍기/놓기, 총쏘기, 재장전은 무기 컴포넌트가 담당한다.
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Pistol)
+	class UWeaponComponent* weaponComp;
 
-	// 잡은 총 액터
+	// 예전에 캐릭터에 있던 폭발VFX. 블루프린트에 저장된 값을 읽어서 weaponComp의 기본 무기로 옮긴다.
 	UPROPERTY()
-	class AActor* grabPistol;
-
-	// 총을 손에 붙이는 기능
-	void AttachPistol(const AActor* pistol);
-	// 총을 손에서 떼는 기능
-	void DetachPistol(const AActor* pistol);
+	class UParticleSystem* ExplosionVFXFactory_DEPRECATED;
 
 	// 마우스 왼쪽 버튼을 클릭하면
 	// 총을 쏘고싶다. 부딪힌것이 있다면 그곳에 폭발VFX를 표현하고싶다.
@@ -119,38 +139,23 @@ public:
 
 	void Fire( const FInputActionValue& Value );
 
-	// - 폭발VFX공장
-	UPROPERTY(EditDefaultsOnly)
-	class UParticleSystem* ExplosionVFXFactory;
-
 	UPROPERTY()
 	class UMainUI* mainUI;
 
-	UPROPERTY(EditDefaultsOnly)
-	int32 maxBulletCount = 21;
-
-	UPROPERTY(Replicated)
-	int32 bulletCount = maxBulletCount;
-
 	UPROPERTY( EditAnywhere , BlueprintReadOnly , Category = Input )
 	UInputAction* ReloadAction;
 
 	void Reload( const FInputActionValue& Value );
 
-	void InitAmmo();
-	// 재장전 중에
-	// 재장전을 막고싶다.
-	// 총쏘기도 막고싶다.
-	bool isReload;
-
-	UPROPERTY(EditDefaultsOnly , BlueprintReadOnly )
+	UPROPERTY(EditDefaultsOnly , BlueprintReadOnly , meta = (ClampMin = "1" , ClampMax = "127") )
 	int32 maxHP = 3;
 
-	UPROPERTY(ReplicatedUsing=OnRep_HP, EditDefaultsOnly, BlueprintReadOnly )
-	int32 hp = maxHP;
+	// hp와 죽음 여부를 한번에 리플리케이트하고 OnRep도 하나로 처리하고싶다.
+	UPROPERTY(ReplicatedUsing=OnRep_Vitals )
+	FCharacterVitals vitals;
 
 	UFUNCTION()
-	void OnRep_HP();
+	void OnRep_Vitals( const FCharacterVitals& oldVitals );
 
 	// hp를 property를 이용해서 접근하고싶다.
 	//__declspec(property(get = GetHP , put = SetHP)) int32 HP;
@@ -165,61 +170,17 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadWrite)
 	class UWidgetComponent* hpUIComp;
 
+	// 화면 체력바 레이어가 그려줄 때는 hpUIComp를 끄고, 아니면 켜서 빌보드 처리하고싶다.
+	void SetScreenSpaceHPBar( bool bScreenSpace );
+
 	UPROPERTY()
 	class UHPBarWidget* hpUI;
 
-	UPROPERTY(Replicated, EditDefaultsOnly)
-	bool bDie = false;
+	bool IsDead() const { return vitals.IsDead(); }
 
 
 	// Network ----------------------------------------------
 
-	void PrintNetLog();
-
-	// 클라2서버 손에 붙여주세요(총액터의 포인터)
-	UFUNCTION(Server, Reliable)
-	void ServerAttachPistol( AActor* pistol ); // 요청
-	//void ServerAttachPistol_Implementation( AActor* pistol ); // 응답
-
-	// 서버2멀티 손에 붙이세요(총액터의 포인터)
-	UFUNCTION(NetMulticast, Reliable)
-	void MultiAttachPistol( AActor* pistol );
-
-	// 손에서 총을 놓고싶다.
-	// 클라2서버 총을 놓아주세요(총액의 포인터)
-	UFUNCTION( Server , Reliable, WithValidation )
-	void ServerDetachPistol( AActor* pistol );
-	// 서버2멀티 모두 총을 놓으세요(총액의 포인터)
-	UFUNCTION( NetMulticast , Reliable )
-	void MultiDetachPistol( AActor* pistol );
-
-
-	// 사용자가 총을 쏘면
-	// 서버에게 총을 쏴 달라고하고싶다.
-	// 서버에서 라인을 그려서 부딪힌것이 있다면
-	// 그 정보를 모든 클라이언트에게 보내서 총쏘기 처리를 하고싶다.
-	UFUNCTION( Server , Reliable  )
-	void ServerFire();
-	
-	UFUNCTION( NetMulticast , Reliable )
-	void MultiFire(bool bHit, const FHitResult& hitInfo, int32 newBulletCount );
-
-
-	// 클라2서버 재장전 애니메이션을 요청
-	UFUNCTION( Server , Reliable )
-	void ServerReload();
-	// 서버2멀티 재장전애니메이션 해라
-	UFUNCTION( NetMulticast , Reliable )
-	void MultiReload();
-
-	// 클라2서버 initAmmo를 해주세요.
-	UFUNCTION( Server , Reliable )
-	void ServerInitAmmo();
-	// 서버2멀티 initAmmo를 해라
-	UFUNCTION( NetMulticast , Reliable )
-	void MultiInitAmmo();
-	// 애니메이션이 끝나면 ServerInitAmmo 가 불리면
-
 	void DamageProcess();
 
 	UPROPERTY( EditAnywhere , BlueprintReadOnly , Category = Input )
@@ -233,12 +194,6 @@ public:
 
 	void ChatFlag( const FInputActionValue& Value );
 
-	UFUNCTION(Server, Reliable)
-	void ServerSendMsg(const FString& msg);
-
-	UFUNCTION( NetMulticast, Reliable )
-	void MultiSendMsg( const FString& msg );
-
 	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
 
 
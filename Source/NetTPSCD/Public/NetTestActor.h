@@ -4,6 +4,8 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/Actor.h"
+#include "KinematicMotion.h"
+#include "ScheduledTasks.h"
 #include "NetTestActor.generated.h"
 
 UCLASS()
@@ -19,6 +21,8 @@ protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
 
+	virtual void EndPlay( const EEndPlayReason::Type EndPlayReason ) override;
+
 public:	
 	// Called every frame
 	virtual void Tick(float DeltaTime) override;
@@ -26,11 +30,28 @@ public:
 	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly)
 	class UStaticMeshComponent* meshComp;
 
-	void PrintNetLog();
+	// 휴면, 업데이트 빈도, 컬링 거리를 정한다.
+	UPROPERTY(VisibleAnywhere)
+	class UNetRepPolicyComponent* netPolicyComp;
 
 	UPROPERTY(EditDefaultsOnly)
 	float detectRadius = 300.0f;
 
+	// 오너를 다시 찾는 간격 (초)
+	UPROPERTY(EditDefaultsOnly)
+	float ownerCheckInterval = 0.2f;
+
+	// 오너가 이만큼 더 멀어지거나, 다른 플레이어가 이만큼 더 가까워야 오너를 바꾼다. (경계에서 깜빡이지 않게)
+	UPROPERTY(EditDefaultsOnly)
+	float ownerHysteresis = 50.0f;
+
+	// 오너를 바꾼 뒤 이 시간(초) 동안은 다시 바꾸지 않는다.
+	UPROPERTY(EditDefaultsOnly)
+	float minOwnerHoldTime = 0.5f;
+
+	double nextOwnerCheckTime = 0;
+	double lastOwnerChangeTime = -1000;
+
 	void FindOwner();
 
 
@@ -38,19 +59,17 @@ public:
 	// 함수 리플리케이트 : (RPC, Remote Procedure Call)
 
 	// 속성 리플리케이트 : 이벤트방식
-	UPROPERTY(ReplicatedUsing=OnRep_RotYaw)
-	float rotYaw;
-
-	UFUNCTION()
-	void OnRep_RotYaw();
-
-	// 보간처리를 하고싶다. (클라이언트에서만 처리)
-	// 현재시간은 계속 흘러가야한다.
-	// OnRep_RotYaw함수가 호출되면 최근시간에 현재시간값을 담는다. 현재시간을 다시 0으로 초기화한다.
-	float currentTime;
-	float latestTime;
+	// 회전값을 계속 보내지 않고 회전 속도와 시작 시간만 보낸다.
+	// 서버와 클라 모두 서버 시간으로 같은 회전값을 계산하므로 보간이 필요없다.
+	UPROPERTY(Replicated)
+	FKinematicMotion motion;
 
+	// 초당 회전 각도
+	UPROPERTY(EditDefaultsOnly)
+	float rotSpeed = 360.0f;
 
+	// 서버에서 회전 속도를 바꾸고싶다. 바뀔 때만 리플리케이트된다.
+	void SetRotSpeed( float newRotSpeed );
 
 	void SelfRotation( const float& DeltaTime );
 
@@ -59,29 +78,35 @@ public:
 	// 태어날 때 호출될 함수
 	void ChangeMatColor();
 
-	UPROPERTY()
-	class UMaterialInstanceDynamic* mat;
+	// 서버에서 방에 있는 동안만 matColorInterval마다 불려서 색을 바꾸고싶다.
+	void OnChangeMatColorTimer();
 
-	//UPROPERTY(ReplicatedUsing=OnRep_ChangeMatColor)
-	UPROPERTY()
-	FLinearColor matColor;
+	// 색을 바꾸는 간격. netPolicyComp의 flushChangeInterval보다 길면 휴면한 채로 바뀔 때만 보낸다.
+	UPROPERTY(EditDefaultsOnly)
+	float matColorInterval = 1.0f;
 
-	//UFUNCTION()
-	//void OnRep_ChangeMatColor(); // 색을 바꾸는 일을 하고싶다.
+	// 방에 들어가면 색 바꾸기 타이머를 켜고, 나오면 끄고싶다.
+	void OnRoomMembershipChanged( bool bInRoom );
 
-	// RPC : 함수 동기화
-	// Server : 클라가 서버에게 Call
-	// Client : 서버가 해당 클라에게 Call : Authority <-> AutonomousProxy
-	// NetMulticast : 서버가 해당 클라들에게 Call : Authority <-> Any Proxy
+	FDelegateHandle roomMembershipHandle;
 
-	UFUNCTION(Server, Reliable)
-	void ServerChangeMatColor( FLinearColor color);
+	// 타이머 핸들은 액터가 들고 있고 EndPlay에서 모두 취소한다.
+	FScheduledTasks tasks;
+	int32 matColorTask = INDEX_NONE;
 
-	UFUNCTION( Client, Reliable )
-	void ClientChangeMatColor( FLinearColor color );
+	UPROPERTY()
+	class UMaterialInstanceDynamic* mat;
+
+	// 색은 RPC가 아니라 속성으로 리플리케이트한다.
+	// 멀리 있거나 휴면 중이면 보내지 않고, 다시 relevant해지면 마지막 색만 받는다.
+	UPROPERTY(ReplicatedUsing=OnRep_MatColor)
+	FLinearColor matColor;
+
+	UFUNCTION()
+	void OnRep_MatColor(); // 색을 바꾸는 일을 하고싶다.
 
-	UFUNCTION( NetMulticast, Reliable )
-	void MulticastChangeMatColor( FLinearColor color);
+	// 서버에서 색을 바꾸고 리플리케이트하고싶다.
+	void SetMatColor( const FLinearColor& color );
 
 
 
@@ -0,0 +1,65 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "PickupSubsystem.generated.h"
+
+/**
+ * 주인이 없는(바닥에 놓인) 총들을 균일 격자로 기억해두고
+ * 주울 때 근처 칸만 검사해서 가장 가까운 총을 찾고싶다.
+ */
+UCLASS()
+class NETTPSCD_API UPickupSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+	// 바닥에 놓인 총을 등록한다. 떨어지는 중이라면 멈출 때까지 칸을 갱신한다.
+	void AddPickup( AActor* pickup );
+	// 누군가 손에 쥐면 등록을 해제한다.
+	void RemovePickup( AActor* pickup );
+
+	// location에서 radius 안의 주인 없는 총 중 가장 가까운 것
+	AActor* FindNearestPickup( const FVector& location , float radius ) const;
+
+	// 주울 수 있는 액터인가? (Pickup 태그가 있거나 BP_Pistol 계열)
+	bool IsPickupActor( const AActor* actor ) const;
+
+	// 격자 한 칸의 크기. 줍기 반경(150)보다 조금 크게 잡는다.
+	static constexpr float CellSize = 200.0f;
+
+private:
+	// 총의 위치는 액터가 아니라 손에 붙였다 떼는 메시를 기준으로 한다.
+	struct FPickupEntry
+	{
+		TWeakObjectPtr<AActor> actor;
+		TWeakObjectPtr<USceneComponent> body;
+	};
+
+	void OnActorSpawned( AActor* actor );
+
+	UFUNCTION()
+	void OnPickupDestroyed( AActor* destroyedActor );
+
+	FIntVector ToCell( const FVector& location ) const;
+	void InsertToCell( const FPickupEntry& entry , const FIntVector& cell );
+	void RemoveFromCell( AActor* pickup );
+
+	TMap<FIntVector , TArray<FPickupEntry , TInlineAllocator<4>>> cells;
+	// 각 총이 들어있는 칸
+	TMap<TWeakObjectPtr<AActor> , FIntVector> pickupCells;
+	// 물리로 움직이는 중이라 매 프레임 칸을 갱신해야하는 총들
+	TArray<FPickupEntry> movingPickups;
+
+	// 클래스마다 이름 검사는 한번만 하고싶다.
+	mutable TMap<const UClass* , bool> pickupClassCache;
+
+	FDelegateHandle actorSpawnedHandle;
+};
@@ -0,0 +1,50 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "ProximitySubsystem.generated.h"
+
+/**
+ * 서버에서 플레이어 캐릭터들의 위치를 프레임마다 한번만 격자(공간 해시)에 넣어두고
+ * 근처 칸만 검사해서 "반경 안의 가장 가까운 플레이어"를 찾고싶다.
+ * 가까이 온 플레이어를 오너로 삼는 소품이 아무리 많아도 TActorIterator를 돌지 않는다.
+ */
+UCLASS()
+class NETTPSCD_API UProximitySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	void Register( class ANetTPSCDCharacter* character );
+	void Unregister( ANetTPSCDCharacter* character );
+
+	// location에서 radius 안의 캐릭터 중 가장 가까운 것. outDistance에 거리를 담는다.
+	ANetTPSCDCharacter* FindNearestCharacter( const FVector& location , float radius , float* outDistance = nullptr ) const;
+
+	// 격자 한 칸의 크기. 소품의 감지 반경(300)보다 조금 크게 잡는다.
+	static constexpr float CellSize = 500.0f;
+
+private:
+	struct FProximityEntry
+	{
+		ANetTPSCDCharacter* character;
+		FVector location;
+		FIntVector cell;
+	};
+
+	FIntVector ToCell( const FVector& location ) const;
+
+	// 이번 프레임에 처음 검색할 때 한번만 격자를 다시 만든다.
+	void RebuildIfNeeded() const;
+
+	TArray<TWeakObjectPtr<ANetTPSCDCharacter>> characters;
+
+	// 칸 순서로 정렬된 위치들과 각 칸의 시작 인덱스/갯수. 메모리는 다시 쓴다.
+	mutable TArray<FProximityEntry> entries;
+	mutable TMap<FIntVector , TPair<int32 , int32>> cellRanges;
+	mutable uint64 builtFrame = MAX_uint64;
+};
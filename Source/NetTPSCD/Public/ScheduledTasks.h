@@ -0,0 +1,41 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "TimerManager.h"
+
+/**
+ * 액터가 멤버로 가지고 있는 타이머 목록.
+ * - 핸들을 지역변수로 잃어버리지 않도록 여기서 들고 있고, 끝난 칸은 다시 쓴다.
+ * - 람다 대신 UObject 멤버함수로 묶으므로(약한 참조) 주인이 사라지면 불리지 않는다.
+ * - 주인의 EndPlay에서 CancelAll을 부르면 남은 타이머가 모두 지워진다.
+ * 타이머 데이터 자체는 FTimerManager가 자기 풀에서 꺼내 쓴다.
+ */
+class NETTPSCD_API FScheduledTasks
+{
+public:
+	// owner의 func를 rate초 뒤(bLoop면 rate초마다) 호출하고싶다.
+	// task에 이미 예약된 것이 있으면 바꾼다. 처음이면 INDEX_NONE으로 두고 부른다.
+	template<typename UserClass>
+	void Schedule( int32& task , UserClass* owner , void (UserClass::*func)() , float rate , bool bLoop )
+	{
+		Schedule( task , owner , FTimerDelegate::CreateUObject( owner , func ) , rate , bLoop );
+	}
+
+	void Schedule( int32& task , UObject* owner , FTimerDelegate&& delegate , float rate , bool bLoop );
+
+	// 예약을 취소하고 task를 INDEX_NONE으로 되돌린다.
+	void Cancel( int32& task , const UObject* owner );
+
+	bool IsScheduled( int32 task , const UObject* owner ) const;
+
+	// 남은 타이머를 모두 지운다. (EndPlay에서 부른다)
+	void CancelAll( const UObject* owner );
+
+private:
+	// 취소된 칸을 찾는다. 없으면 새로 만든다.
+	int32 AllocSlot();
+
+	TArray<FTimerHandle , TInlineAllocator<4>> handles;
+};
@@ -0,0 +1,83 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SignificanceSubsystem.generated.h"
+
+// 중요도 단계 하나의 설정. 가까운 단계부터 순서대로 검사한다.
+USTRUCT()
+struct FSignificanceBucket
+{
+	GENERATED_BODY()
+
+	// 이 거리 안에 있어야 이 단계가 된다.
+	UPROPERTY( config )
+	float maxDistance = 0;
+
+	// 화면에 보이지 않아도 이 단계가 될 수 있는가?
+	UPROPERTY( config )
+	bool bAllowHidden = false;
+
+	// 메시(애니메이션) Tick 간격. 0이면 매 프레임
+	UPROPERTY( config )
+	float tickInterval = 0;
+
+	// 서버에서 이 단계일 때의 NetUpdateFrequency / NetPriority 배율
+	UPROPERTY( config )
+	float netUpdateScale = 1;
+
+	UPROPERTY( config )
+	float netPriorityScale = 1;
+};
+
+/**
+ * 캐릭터들을 거리와 보이는지로 단계를 나누고 먼 캐릭터일수록 애니메이션 Tick과 리플리케이트 빈도를 줄이고싶다.
+ * 애니메이션은 내 카메라 기준, 리플리케이트는 서버에서 가장 가까운 다른 플레이어와의 거리로만 정한다.
+ */
+UCLASS( config = Game )
+class NETTPSCD_API USignificanceSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USignificanceSubsystem();
+
+	virtual void Deinitialize() override;
+	virtual void Tick( float DeltaTime ) override;
+	virtual TStatId GetStatId() const override;
+
+	void Register( class ANetTPSCDCharacter* character );
+	void Unregister( ANetTPSCDCharacter* character );
+
+	// 가까운 순서의 단계들. 어디에도 안 들어가면 마지막 단계
+	UPROPERTY( config )
+	TArray<FSignificanceBucket> buckets;
+
+	// 단계를 다시 계산하는 간격 (초)
+	UPROPERTY( config )
+	float updateInterval = 0.25f;
+
+private:
+	struct FSignificanceEntry
+	{
+		TWeakObjectPtr<ANetTPSCDCharacter> character;
+		// 애니메이션 단계 (내 화면 기준) / 리플리케이트 단계 (서버에서 보는 플레이어들과의 거리 기준)
+		int32 bucket = INDEX_NONE;
+		int32 netBucket = INDEX_NONE;
+		// 등록할 때의 원래 값 (가장 높은 단계에서 쓴다)
+		float baseNetUpdateFrequency = 0;
+		float baseNetPriority = 0;
+	};
+
+	int32 CalcBucket( double distSq , bool bVisible ) const;
+	// 서버에서 이 캐릭터와 가장 가까운 다른 플레이어까지의 거리(제곱)
+	double CalcViewerDistSq( const ANetTPSCDCharacter* character ) const;
+	void ApplyAnimBucket( FSignificanceEntry& entry , int32 bucket , bool bServer );
+	void ApplyNetBucket( FSignificanceEntry& entry , int32 bucket );
+
+	TArray<FSignificanceEntry> entries;
+
+	float updateTime = 0;
+};
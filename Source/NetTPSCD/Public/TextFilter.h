@@ -0,0 +1,43 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * 금지어 목록을 Aho-Corasick 오토마타로 한번만 만들어두고
+ * 문장을 한번만 훑어서(단어 수와 상관없이 길이에 비례) 금지어를 찾거나 가리고싶다.
+ * 한글은 글자 그대로, 영문은 대소문자를 구분하지 않고 비교한다.
+ */
+class NETTPSCD_API FTextFilter
+{
+public:
+	// 금지어 목록으로 오토마타를 다시 만든다.
+	void Build( const TArray<FString>& words );
+
+	bool IsEmpty() const { return nodes.Num() <= 1; }
+
+	// 금지어가 하나라도 들어있는가?
+	bool Contains( const FString& text ) const;
+
+	// 금지어를 글자 수만큼 '*'로 바꾼다. 바꾼 것이 있으면 true
+	bool Mask( FString& text ) const;
+
+private:
+	struct FNode
+	{
+		// 다음 글자 -> 자식 노드
+		TMap<TCHAR , int32> next;
+		// 실패했을 때 돌아갈 노드
+		int32 fail = 0;
+		// 이 노드에서 끝나는 가장 긴 금지어의 길이 (없으면 0)
+		int32 matchLength = 0;
+	};
+
+	static TCHAR Normalize( TCHAR c ) { return FChar::ToLower( c ); }
+
+	// state에서 c를 읽었을 때의 다음 상태
+	int32 Step( int32 state , TCHAR c ) const;
+
+	TArray<FNode> nodes;
+};
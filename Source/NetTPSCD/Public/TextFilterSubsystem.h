@@ -0,0 +1,36 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/GameInstanceSubsystem.h"
+#include "TextFilter.h"
+#include "TextFilterSubsystem.generated.h"
+
+/**
+ * 금지어 목록을 설정 파일에서 한번만 읽어서 FTextFilter로 만들어두고
+ * 로비의 방 이름, 채팅 등 여러 곳에서 같이 쓰고싶다.
+ * 목록은 DefaultGame.ini 의 [/Script/NetTPSCD.TextFilterSubsystem] +badWords= 로 추가한다.
+ */
+UCLASS( config = Game )
+class NETTPSCD_API UTextFilterSubsystem : public UGameInstanceSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize( FSubsystemCollectionBase& Collection ) override;
+
+	// worldContext가 속한 게임인스턴스의 필터. 없으면 nullptr
+	static UTextFilterSubsystem* Get( const UObject* worldContext );
+
+	bool Contains( const FString& text ) const { return filter.Contains( text ); }
+	bool Mask( FString& text ) const { return filter.Mask( text ); }
+
+	const FTextFilter& GetFilter() const { return filter; }
+
+	UPROPERTY( config )
+	TArray<FString> badWords;
+
+private:
+	FTextFilter filter;
+};
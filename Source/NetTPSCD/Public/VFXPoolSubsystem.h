@@ -0,0 +1,67 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "VFXPoolSubsystem.generated.h"
+
+// 풀에서 꺼낸 VFX 하나를 가리킨다.
+// 풀의 컴포넌트는 파괴되지 않고 다시 쓰이므로, 꺼낼 때마다 바뀌는 번호로 같은 재생인지 확인한다.
+struct FPooledVFXHandle
+{
+	TWeakObjectPtr<class UParticleSystemComponent> comp;
+	// 풀 밖에서 만든 (끝나면 파괴되는) 컴포넌트라면 INDEX_NONE
+	int32 poolIndex = INDEX_NONE;
+	uint32 activationId = 0;
+};
+
+/**
+ * 총알이 부딪힐 때마다 파티클 컴포넌트를 새로 만들지 않고
+ * 미리 만들어둔 컴포넌트들을 돌려쓰고싶다.
+ * 끝난 컴포넌트가 없으면 최대 갯수까지 늘리고, 그래도 없으면 가장 오래된 것을 뺏어쓴다.
+ */
+UCLASS( config = Game )
+class NETTPSCD_API UVFXPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void OnWorldBeginPlay( UWorld& InWorld ) override;
+	virtual void Deinitialize() override;
+
+	// 풀에서 컴포넌트를 꺼내서 location에 재생하고싶다. 너무 멀어서 안 보이면 nullptr
+	// outHandle을 주면 나중에 Release로 이 재생만 끌 수 있다.
+	class UParticleSystemComponent* SpawnAtLocation( class UParticleSystem* vfx , const FVector& location , const FRotator& rotation , FPooledVFXHandle* outHandle = nullptr );
+
+	// handle이 가리키는 재생을 바로 끄고싶다. 그 사이 다른 곳에서 다시 꺼내 쓴 컴포넌트라면 건드리지 않는다.
+	void Release( const FPooledVFXHandle& handle );
+
+	// 시작할 때 미리 만들어둘 갯수
+	UPROPERTY( config )
+	int32 preallocateCount = 16;
+
+	// 풀의 최대 크기
+	UPROPERTY( config )
+	int32 maxPoolSize = 32;
+
+	// 로컬 카메라에서 이보다 멀면 재생하지 않는다.
+	UPROPERTY( config )
+	float cullDistance = 8000;
+
+private:
+	UParticleSystemComponent* CreatePooledComponent();
+	// 재생이 끝난 컴포넌트를 찾는다. 없으면 INDEX_NONE
+	int32 FindFreeIndex() const;
+	bool IsCulled( const FVector& location ) const;
+
+	UPROPERTY()
+	TArray<UParticleSystemComponent*> pool;
+
+	// pool의 각 컴포넌트를 마지막으로 꺼냈을 때의 번호
+	TArray<uint32> activationIds;
+	uint32 nextActivationId = 0;
+
+	// 다음에 검사하거나 뺏어쓸 위치. 돌아가면서 쓰므로 가장 오래된 것을 가리킨다.
+	int32 cursor = 0;
+};
@@ -0,0 +1,210 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+#include "FireEvent.h"
+#include "VFXPoolSubsystem.h"
+#include "WeaponTable.h"
+#include "WeaponComponent.generated.h"
+
+// 캐릭터의 무기 상태. 모두 합쳐서 20비트로 리플리케이트한다.
+USTRUCT()
+struct FWeaponState
+{
+	GENERATED_BODY()
+
+	static constexpr uint32 WeaponIdBits = 4;
+	static constexpr uint32 AmmoBits = FFireEvent::BulletCountBits;
+	// 테이블에 없는 총이나 빈손일 때 쓰는 UWeaponComponent::defaultWeapon의 아이디 (4비트의 마지막 값)
+	static constexpr uint8 DefaultWeaponId = (1 << WeaponIdBits) - 1;
+
+	// UWeaponTable::weapons의 인덱스. DefaultWeaponId면 기본 무기
+	UPROPERTY()
+	uint8 weaponId = DefaultWeaponId;
+
+	UPROPERTY()
+	uint8 ammo = 0;
+
+	UPROPERTY()
+	bool bEquipped = false;
+
+	UPROPERTY()
+	bool bReloading = false;
+
+	// 서버가 마지막으로 처리한 예측 총알 번호. 주인 클라이언트가 예측을 정리할 때 쓴다.
+	UPROPERTY()
+	uint8 ackFireSeq = 0;
+
+	bool NetSerialize( FArchive& Ar , class UPackageMap* Map , bool& bOutSuccess );
+};
+
+template<>
+struct TStructOpsTypeTraits<FWeaponState> : public TStructOpsTypeTraitsBase2<FWeaponState>
+{
+	enum
+	{
+		WithNetSerializer = true,
+	};
+};
+
+/**
+ * 캐릭터의 무기 줍기/놓기, 총쏘기, 재장전을 담당하고싶다.
+ * 무기 종류별 수치는 UWeaponTable에서 가져오고, 리플리케이트는 FWeaponState 하나로 한다.
+ */
+UCLASS( ClassGroup=(Custom), meta=(BlueprintSpawnableComponent) )
+class NETTPSCD_API UWeaponComponent : public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	UWeaponComponent();
+
+	virtual void OnRegister() override;
+
+protected:
+	virtual void BeginPlay() override;
+
+public:
+	UPROPERTY()
+	class ANetTPSCDCharacter* player;
+
+	// 무기 데이터 ------------------------------------------
+	UPROPERTY( EditDefaultsOnly , Category = Weapon )
+	class UWeaponTable* weaponTable;
+
+	// 테이블이 없거나 테이블에 없는 무기를 주웠을 때, 빈손일 때 쓰는 기본 무기 (권총)
+	// 리플리케이트할 때는 FWeaponState::DefaultWeaponId로 보낸다.
+	UPROPERTY( EditDefaultsOnly , Category = Weapon )
+	FWeaponDefinition defaultWeapon;
+
+	const FWeaponDefinition& GetDefinition() const;
+	const FWeaponDefinition& GetDefinition( int32 weaponId ) const;
+	int32 GetMaxBulletCount() const;
+
+	// 총을 잡을 수 있는 검색 거리
+	UPROPERTY( EditDefaultsOnly , Category = Weapon )
+	float findWeaponRadius = 150;
+
+	// 리플리케이트 상태 ------------------------------------
+	UPROPERTY( ReplicatedUsing = OnRep_WeaponState )
+	FWeaponState state;
+
+	// 재장전 시작/끝과 총알 수를 반영하고싶다.
+	UFUNCTION()
+	void OnRep_WeaponState( const FWeaponState& oldState );
+
+	// 서버에서 state를 바꾼 뒤 호출해서 다음 리플리케이트 때 비교되게 하고싶다.
+	void MarkStateDirty();
+
+	bool HasWeapon() const { return state.bEquipped; }
+	bool IsReloading() const { return state.bReloading; }
+
+	// 잡은 총 액터. 늦게 들어온 클라이언트도 OnRep으로 손에 붙인다.
+	UPROPERTY( ReplicatedUsing = OnRep_GrabWeapon )
+	class AActor* grabWeapon;
+
+	UFUNCTION()
+	void OnRep_GrabWeapon( AActor* oldWeapon );
+
+	// 화면에 보이는 총알 수. 주인 클라이언트에서는 예측값이다.
+	int32 bulletCount = 0;
+
+	// 줍기/놓기 --------------------------------------------
+	void PickupWeapon();
+	void DropWeapon();
+
+	// 총을 손에 붙이는 기능
+	void AttachWeapon( AActor* weapon );
+	// 총을 손에서 떼는 기능
+	void DetachWeapon( AActor* weapon );
+
+	// 서버에서 잡은 총을 바꾸고 리플리케이트 상태에 반영하고싶다. (nullptr이면 놓기)
+	void SetGrabWeapon( AActor* weapon );
+
+	// 클라2서버 손에 붙여주세요(총액터의 포인터)
+	UFUNCTION( Server , Reliable )
+	void ServerAttachWeapon( AActor* weapon );
+
+	// 클라2서버 총을 놓아주세요(총액의 포인터)
+	UFUNCTION( Server , Reliable , WithValidation )
+	void ServerDetachWeapon( AActor* weapon );
+
+	// 총쏘기 ----------------------------------------------
+	void Fire();
+
+	// clientFireTime : 클라이언트가 총을 쏜 순간의 서버시간. 서버는 이 시점으로 되감아서 판정한다.
+	// fireSeq : 클라이언트가 예측해서 먼저 보여준 총알의 번호 (서버가 직접 쏘면 0)
+	UFUNCTION( Server , Reliable )
+	void ServerFire( double clientFireTime , uint8 fireSeq );
+
+	// 총쏘기 연출은 신뢰성 없이, 보이는 클라이언트에게만, 연결마다 횟수를 제한해서 보내고싶다.
+	void SendFireCosmetic( const FFireEvent& fireEvent , uint8 fireSeq );
+
+	// 총쏘기 애니메이션과 폭발VFX를 보여준다. (ANetPlayerController::ClientFireCosmetic에서 호출)
+	void PlayFireCosmetic( const FFireEvent& fireEvent );
+
+	// 부딪힌 곳에 폭발VFX를 보여준다. 매번 만들지 않고 UVFXPoolSubsystem에서 꺼내쓴다.
+	// outHandle을 주면 나중에 ReleaseImpactVFX로 이 재생만 끌 수 있다.
+	class UParticleSystemComponent* SpawnImpactVFX( const FVector& location , const FRotator& rotation , FPooledVFXHandle* outHandle = nullptr );
+	void ReleaseImpactVFX( const FPooledVFXHandle& handle );
+
+	// 연출을 보낼 최대 거리
+	UPROPERTY( EditDefaultsOnly , Category = Weapon )
+	float cosmeticCullDistance = 15000;
+
+	// 서버2클라 예측한 총알이 무효라고 알려준다. (총알 수와 탄퍼짐 순번을 서버값으로 되돌린다)
+	UFUNCTION( Client , Reliable )
+	void ClientRejectFire( uint8 fireSeq , int32 serverBulletCount , int32 nextShotIndex );
+
+	// 탄퍼짐을 적용한 방향. 클라이언트 예측과 서버가 같은 결과를 내도록
+	// 서버가 정한 spreadSalt와 서버가 받아들인 총알 순번으로 난수를 정한다.
+	// 클라이언트가 보내는 fireSeq는 쓰지 않으므로 클라이언트가 탄퍼짐을 고를 수 없다.
+	FVector GetFireDirection( const FVector& forward , int32 shotIndex ) const;
+
+	// 서버가 태어날 때 정해서 주인 클라이언트에게만 보내는 탄퍼짐 난수 씨앗
+	UPROPERTY( Replicated )
+	int32 spreadSalt = 0;
+
+	// 서버가 받아들인 총알 수 / 주인 클라이언트가 예측한 다음 총알 순번
+	int32 serverShotIndex = 0;
+	int32 predictedShotIndex = 0;
+
+	// 발사 간격 검사용 (입력 / 서버). 서버 쪽은 클라이언트가 쏜 서버시간을 기억한다.
+	double lastFireTime = -1;
+	double lastServerFireTime = -1;
+
+	// 클라이언트 예측 ---------------------------------------
+	// 서버 응답을 기다리지 않고 총쏘기 애니메이션, 총알UI, 임시 VFX를 먼저 보여주고싶다.
+	struct FPredictedShot
+	{
+		uint8 fireSeq;
+		// 풀의 컴포넌트는 다시 쓰이므로 약한 포인터가 아니라 핸들로 기억한다.
+		FPooledVFXHandle vfx;
+	};
+
+	// 마지막으로 쏜 총알 번호
+	uint8 lastFireSeq = 0;
+	// 서버의 확인을 기다리는 총알들 (오래된 순)
+	TArray<FPredictedShot> predictedShots;
+
+	void PredictFire( uint8 fireSeq );
+	// fireSeq까지의 예측을 정리하고 서버 총알 수에 아직 남은 예측분을 반영하고싶다.
+	void ReconcileFire( uint8 fireSeq , int32 serverBulletCount , bool bRejected );
+
+	// 재장전 ----------------------------------------------
+	void Reload();
+
+	// 클라2서버 재장전을 요청. 애니메이션은 state.bReloading의 OnRep으로 재생된다.
+	UFUNCTION( Server , Reliable )
+	void ServerReload();
+
+	// 클라2서버 initAmmo를 해주세요. 결과는 state로 리플리케이트된다.
+	UFUNCTION( Server , Reliable )
+	void ServerInitAmmo();
+
+	void InitAmmo();
+
+	virtual void GetLifetimeReplicatedProps( TArray<FLifetimeProperty>& OutLifetimeProps ) const override;
+};
@@ -0,0 +1,60 @@
+﻿// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "WeaponTable.generated.h"
+
+// 무기 한 종류의 데이터. 새 무기는 코드 수정 없이 테이블에 한 줄 추가하면 된다.
+USTRUCT(BlueprintType)
+struct FWeaponDefinition
+{
+	GENERATED_BODY()
+
+	// 이 무기로 취급할 줍기 액터 클래스 (BP_Pistol 등)
+	UPROPERTY( EditDefaultsOnly )
+	TSoftClassPtr<AActor> pickupClass;
+
+	// 초당 발사 수
+	UPROPERTY( EditDefaultsOnly , meta = (ClampMin = "0.1") )
+	float fireRate = 5.0f;
+
+	// 탄창 크기 (리플리케이트할 때 6비트로 보내므로 최대 63)
+	UPROPERTY( EditDefaultsOnly , meta = (ClampMin = "1" , ClampMax = "63") )
+	int32 magazineSize = 21;
+
+	// 탄퍼짐 (원뿔 반각, 도)
+	UPROPERTY( EditDefaultsOnly , meta = (ClampMin = "0") )
+	float spread = 0.0f;
+
+	// 사거리
+	UPROPERTY( EditDefaultsOnly )
+	float range = 100000.0f;
+
+	UPROPERTY( EditDefaultsOnly )
+	int32 damage = 1;
+
+	// 부딪힌 곳에 보여줄 폭발VFX
+	UPROPERTY( EditDefaultsOnly )
+	class UParticleSystem* impactVFX = nullptr;
+};
+
+/**
+ * 게임에서 쓰는 무기 목록. 리플리케이트할 때는 이 배열의 인덱스(4비트)만 보낸다.
+ */
+UCLASS()
+class NETTPSCD_API UWeaponTable : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	// 무기 아이디를 4비트로 보내고 마지막 값(15)은 기본 무기에 쓰므로 최대 15종류
+	static constexpr int32 MaxWeapons = 15;
+
+	UPROPERTY( EditDefaultsOnly , meta = (TitleProperty = "pickupClass") )
+	TArray<FWeaponDefinition> weapons;
+
+	// 줍기 액터의 클래스로 무기 아이디를 찾고싶다. 없으면 INDEX_NONE
+	int32 FindWeaponId( const UClass* pickupClass ) const;
+};